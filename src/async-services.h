@@ -0,0 +1,304 @@
+/**
+ * @file async-services.h
+ * @brief This file contains services whose factories complete asynchronously.
+ */
+
+#ifndef ASYNC_SERVICES_H
+#define ASYNC_SERVICES_H
+#pragma once
+#include <any>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+
+#include "contract-id.h"
+#include "locator.h"
+#include "locator-mutable.h"
+#include "registration-batch.h"
+#include "services-interface.h"
+
+namespace PureIOC {
+namespace detail {
+/**
+ * @brief Starts the construction of an asynchronous service.
+ * @tparam T The type of the service.
+ */
+template <class T>
+using AsyncStart = std::function<std::shared_future<std::shared_ptr<T>>()>;
+
+/**
+ * @brief The pending instance of an asynchronous service, registered alongside the service itself.
+ *
+ * A construction that failed, synchronously or through its future, is
+ * started again by the next resolution, so a lazy singleton recovers from a
+ * failed start instead of keeping the failure. Once the construction
+ * succeeded, the future is handed out without locking.
+ * @tparam T The type of the service.
+ */
+template <class T>
+class AsyncInstance {
+private:
+    const AsyncStart<T> _start;
+    std::mutex _mutex; ///< Guards the future until the construction succeeded.
+    std::shared_future<std::shared_ptr<T>> _future;
+    bool _delivered = false; ///< Whether the current future was handed out.
+    std::atomic<bool> _succeeded{false};
+
+public:
+    /**
+     * @brief Starts the construction.
+     * @param start Starts the construction; called again after a failure.
+     */
+    explicit AsyncInstance(AsyncStart<T> start)
+        : _start(std::move(start)), _future(_start()) {}
+
+    /**
+     * @brief Gets the future of the service, starting the construction again if it failed.
+     *
+     * A failed future is handed out once, so the caller that started the
+     * construction sees why it failed, and replaced by the next call.
+     * @return The future.
+     */
+    std::shared_future<std::shared_ptr<T>> future() {
+        if (_succeeded.load(std::memory_order_acquire)) {
+            return _future;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_delivered || _future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            _delivered = true;
+            return _future;
+        }
+
+        try {
+            _future.get();
+        } catch (...) {
+            _future = _start();
+            return _future;
+        }
+
+        _succeeded.store(true, std::memory_order_release);
+        return _future;
+    }
+};
+
+/**
+ * @brief Checks whether a callable is an asynchronous factory for services of type T.
+ * @tparam T The type of the service.
+ * @tparam F The type of the callable.
+ */
+template <class T, class F>
+constexpr bool isAsyncFactory = std::is_invocable_v<std::decay_t<F> &>
+    && std::is_constructible_v<std::shared_future<std::shared_ptr<T>>, std::invoke_result_t<std::decay_t<F> &>>;
+
+/**
+ * @brief Wraps an asynchronous factory into a function that starts the construction.
+ *
+ * An exception thrown by the factory itself is stored in the future rather
+ * than thrown from the resolution.
+ * @tparam T The type of the service.
+ * @tparam F The type of the callable.
+ * @param factory The callable, returning a std::future or std::shared_future of the service.
+ * @return The function.
+ */
+template <class T, class F>
+AsyncStart<T> makeAsyncStart(F &&factory) {
+    return [f = std::make_shared<std::decay_t<F>>(std::forward<F>(factory))]() -> std::shared_future<std::shared_ptr<T>> {
+        try {
+            return std::shared_future<std::shared_ptr<T>>((*f)());
+        } catch (...) {
+            std::promise<std::shared_ptr<T>> failed;
+            failed.set_exception(std::current_exception());
+            return failed.get_future().share();
+        }
+    };
+}
+
+/**
+ * @brief Registers an asynchronous service and the pending instance it is resolved from.
+ *
+ * Both registrations are committed as one batch, so either both are made or
+ * neither is, and no thread sees one without the other.
+ * @tparam T The type of the service.
+ * @tparam F The type of the callable.
+ * @param lifetime The lifetime of both registrations: Transient or LazySingleton.
+ * @param contract The contract for the service, if any.
+ * @param factory The asynchronous factory.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class F>
+bool registerAsync(ServiceLifetime lifetime, const std::optional<std::string> &contract, F &&factory) {
+    const ContractId id = contract ? internContract(*contract) : ContractId();
+    auto start = [start = makeAsyncStart<T>(std::forward<F>(factory))]() {
+        return std::make_shared<AsyncInstance<T>>(start);
+    };
+    auto wait = [id]() -> std::shared_ptr<T> {
+        std::shared_ptr<AsyncInstance<T>> instance = getService<AsyncInstance<T>>(id);
+        return instance ? instance->future().get() : nullptr;
+    };
+
+    RegistrationBatch batch;
+    if (lifetime == ServiceLifetime::LazySingleton && contract) {
+        batch.addLazySingleton<AsyncInstance<T>>(*contract, std::move(start));
+        batch.addLazySingleton<T>(*contract, std::move(wait));
+    } else if (lifetime == ServiceLifetime::LazySingleton) {
+        batch.addLazySingleton<AsyncInstance<T>>(std::move(start));
+        batch.addLazySingleton<T>(std::move(wait));
+    } else if (contract) {
+        batch.addService<AsyncInstance<T>>(*contract, std::move(start));
+        batch.addService<T>(*contract, std::move(wait));
+    } else {
+        batch.addService<AsyncInstance<T>>(std::move(start));
+        batch.addService<T>(std::move(wait));
+    }
+
+    return batch.commitAll();
+}
+
+/**
+ * @brief Makes a future that is already ready.
+ * @tparam T The type of the service.
+ * @param service The service.
+ * @return The future.
+ */
+template <class T>
+std::shared_future<std::shared_ptr<T>> readyFuture(std::shared_ptr<T> service) {
+    std::promise<std::shared_ptr<T>> ready;
+    ready.set_value(std::move(service));
+    return ready.get_future().share();
+}
+}
+
+/**
+ * @brief Registers a singleton whose factory completes asynchronously.
+ *
+ * The factory is called on the first resolution and must return quickly: it
+ * starts the construction, on a thread pool or an event loop of its own, and
+ * returns a std::future or std::shared_future of the instance. The future
+ * must complete on its own; a deferred future from std::async would only
+ * run when waited on. getServiceAsync() then hands out the shared future
+ * without waiting, so event-loop threads keep serving other work while the
+ * singleton comes up, and getService() waits for it. If the factory throws
+ * or its future fails, callers holding that future see the failure and the
+ * next resolution calls the factory again. A factory that waits on
+ * getService() for its own service deadlocks.
+ * @tparam T The type of the service.
+ * @tparam F The type of the factory.
+ * @param factory The factory, returning a future of the instance.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class F, std::enable_if_t<detail::isAsyncFactory<T, F>, int> = 0>
+bool registerAsyncSingleton(F &&factory) {
+    return detail::registerAsync<T>(ServiceLifetime::LazySingleton, std::nullopt, std::forward<F>(factory));
+}
+
+/**
+ * @brief Registers a singleton whose factory completes asynchronously, with a contract.
+ * @tparam T The type of the service.
+ * @tparam F The type of the factory.
+ * @param contract The contract for the service.
+ * @param factory The factory, returning a future of the instance.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class F, std::enable_if_t<detail::isAsyncFactory<T, F>, int> = 0>
+bool registerAsyncSingleton(const std::string &contract, F &&factory) {
+    return detail::registerAsync<T>(ServiceLifetime::LazySingleton, contract, std::forward<F>(factory));
+}
+
+/**
+ * @brief Registers a transient service whose factory completes asynchronously.
+ *
+ * Each resolution calls the factory and gets a future of a new instance.
+ * @tparam T The type of the service.
+ * @tparam F The type of the factory.
+ * @param factory The factory, returning a future of the instance.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class F, std::enable_if_t<detail::isAsyncFactory<T, F>, int> = 0>
+bool registerAsyncService(F &&factory) {
+    return detail::registerAsync<T>(ServiceLifetime::Transient, std::nullopt, std::forward<F>(factory));
+}
+
+/**
+ * @brief Registers a transient service whose factory completes asynchronously, with a contract.
+ * @tparam T The type of the service.
+ * @tparam F The type of the factory.
+ * @param contract The contract for the service.
+ * @param factory The factory, returning a future of the instance.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class F, std::enable_if_t<detail::isAsyncFactory<T, F>, int> = 0>
+bool registerAsyncService(const std::string &contract, F &&factory) {
+    return detail::registerAsync<T>(ServiceLifetime::Transient, contract, std::forward<F>(factory));
+}
+
+/**
+ * @brief Unregisters an asynchronous service.
+ *
+ * The service and its asynchronous instance are removed at once, as they
+ * were registered, so no reader sees one without the other.
+ * @tparam T The type of the service.
+ */
+template <class T>
+void unregisterAsync() {
+    unregisterAll({ServiceKey{std::type_index(typeid(T)), std::nullopt},
+                   ServiceKey{std::type_index(typeid(detail::AsyncInstance<T>)), std::nullopt}});
+}
+
+/**
+ * @brief Unregisters an asynchronous service with a contract.
+ *
+ * The service and its asynchronous instance are removed at once.
+ * @tparam T The type of the service.
+ * @param contract The contract for the service.
+ */
+template <class T>
+void unregisterAsync(const std::string &contract) {
+    unregisterAll({ServiceKey{std::type_index(typeid(T)), contract},
+                   ServiceKey{std::type_index(typeid(detail::AsyncInstance<T>)), contract}});
+}
+
+/**
+ * @brief Gets a service without waiting for an asynchronous factory to complete.
+ *
+ * The future of an asynchronous service is returned as is; poll it with
+ * wait_for() from an event loop, or wait on it. Any other service is
+ * resolved on the calling thread and returned in a future that is already
+ * ready.
+ * @tparam T The type of the service.
+ * @param contract The interned contract for the service, see internContract().
+ * @return A future of the service, holding nullptr if the service is not registered.
+ */
+template <class T>
+std::shared_future<std::shared_ptr<T>> getServiceAsync(ContractId contract = ContractId()) {
+    if (std::shared_ptr<detail::AsyncInstance<T>> instance = getService<detail::AsyncInstance<T>>(contract)) {
+        return instance->future();
+    }
+
+    return detail::readyFuture<T>(getService<T>(contract));
+}
+
+/**
+ * @brief Gets a service with a contract without waiting for an asynchronous factory to complete.
+ * @tparam T The type of the service.
+ * @param contract The contract for the service.
+ * @return A future of the service, holding nullptr if the service is not registered.
+ */
+template <class T>
+std::shared_future<std::shared_ptr<T>> getServiceAsync(std::string_view contract) {
+    std::optional<ContractId> id = findContract(contract);
+    return id ? getServiceAsync<T>(*id) : detail::readyFuture<T>(nullptr);
+}
+}
+#endif // ASYNC_SERVICES_H
@@ -0,0 +1,245 @@
+/**
+ * @file auto-wiring.h
+ * @brief This file contains the registration of types whose dependencies are wired automatically.
+ */
+
+#ifndef AUTO_WIRING_H
+#define AUTO_WIRING_H
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+
+#include "container-manager.h"
+#include "contract-id.h"
+#include "dependency-recorder.h"
+#include "locator-mutable.h"
+#include "service-entry.h"
+#include "service-handle.h"
+#include "service-slot.h"
+#include "services-interface.h"
+
+namespace PureIOC {
+namespace detail {
+/**
+ * @brief Gets the plan a thread tries first, so threads spread over the plans of a registration.
+ * @return The index of the calling thread, assigned on first use.
+ */
+inline std::size_t wiringSlot() noexcept {
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t slot = next.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+/**
+ * @brief A dependency of a type registered with registerType(), bound weakly to its registration entry.
+ *
+ * Unlike a ServiceHandle, the dependency does not keep the entry alive, so
+ * registrations that wire each other never form a cycle, and an
+ * unregistered entry is released with its instance even if no construction
+ * follows. Like a ServiceHandle, it looks the entry up again when
+ * detail::servicesChanges advances, and keeps no entry while a
+ * DependencyRecorder is alive.
+ * @tparam T The type of the dependency.
+ */
+template <class T>
+class WiredDependency {
+private:
+    ContractId _contract;
+    std::uint64_t _changes = 0; ///< The value of detail::servicesChanges the entry was looked up at.
+    std::weak_ptr<ServiceEntry> _entry;
+
+public:
+    /**
+     * @brief Constructs an unbound dependency.
+     * @param contract The interned contract of the dependency, or the "no contract" id.
+     */
+    explicit WiredDependency(ContractId contract = ContractId()) noexcept
+        : _contract(contract) {}
+
+    /**
+     * @brief Resolves the dependency.
+     * @return A shared pointer to the dependency, or nullptr if not found.
+     */
+    std::shared_ptr<T> get() {
+        const std::uint64_t changes = servicesChanges.load(std::memory_order_acquire);
+        if (_changes == changes) {
+            if (std::shared_ptr<ServiceEntry> entry = _entry.lock()) {
+                return resolveEntry<T>(*entry);
+            }
+        }
+
+        std::shared_ptr<ServiceEntry> entry;
+        if (!liveRecorders.load(std::memory_order_relaxed)) {
+            entry = getEntry(typeSlot<T>(), std::type_index(typeid(T)), _contract);
+        }
+        _entry = entry;
+        _changes = changes;
+
+        return entry ? resolveEntry<T>(*entry) : getService<T>(_contract);
+    }
+};
+
+/**
+ * @brief The resolution plans of a type registered with registerType().
+ *
+ * A plan is a tuple of dependencies. The first construction through a plan
+ * binds each dependency to its registration entry; later constructions
+ * resolve the dependencies straight through those entries, without any
+ * locator lookup, until registrations change. Dependencies are not
+ * synchronized, so the registration keeps a few plans and each construction
+ * takes a free one for its duration; constructions that find none free
+ * resolve through dependencies of their own. The plans belong to the
+ * registration and hold their entries weakly, so they keep no other
+ * registration alive.
+ * @tparam Deps The types of the dependencies, in constructor order.
+ */
+template <class... Deps>
+class WiringPlans {
+private:
+    using Dependencies = std::tuple<WiredDependency<Deps>...>;
+
+    struct alignas(64) Plan {
+        std::atomic<bool> busy{false};
+        Dependencies dependencies;
+    };
+
+    /**
+     * @brief Hands a plan back when a construction ends, even by an exception.
+     */
+    struct Release {
+        std::atomic<bool> &busy;
+
+        ~Release() {
+            busy.store(false, std::memory_order_release);
+        }
+    };
+
+    static constexpr std::size_t Count = 8;
+
+    const std::array<ContractId, sizeof...(Deps)> _contracts;
+    std::array<Plan, Count> _plans;
+
+    template <std::size_t... I>
+    Dependencies makeDependencies(std::index_sequence<I...>) const {
+        return Dependencies(WiredDependency<Deps>(_contracts[I])...);
+    }
+
+    template <class Impl>
+    static std::shared_ptr<Impl> construct(Dependencies &dependencies) {
+        return std::apply([](WiredDependency<Deps> &...resolved) { return std::make_shared<Impl>(resolved.get()...); }, dependencies);
+    }
+
+public:
+    /**
+     * @brief Constructs unbound plans.
+     * @param contracts The interned contract of each dependency.
+     */
+    explicit WiringPlans(const std::array<ContractId, sizeof...(Deps)> &contracts)
+        : _contracts(contracts) {
+        for (Plan &plan : _plans) {
+            plan.dependencies = makeDependencies(std::index_sequence_for<Deps...>());
+        }
+    }
+
+    /**
+     * @brief Constructs an instance whose constructor takes its dependencies as shared pointers.
+     * @tparam Impl The type of the instance.
+     * @return The instance.
+     */
+    template <class Impl>
+    std::shared_ptr<Impl> construct() {
+        const std::size_t first = wiringSlot();
+        for (std::size_t i = 0; i < Count; ++i) {
+            Plan &plan = _plans[(first + i) % Count];
+            if (!plan.busy.load(std::memory_order_relaxed) && !plan.busy.exchange(true, std::memory_order_acquire)) {
+                Release release{plan.busy};
+                return construct<Impl>(plan.dependencies);
+            }
+        }
+
+        Dependencies dependencies = makeDependencies(std::index_sequence_for<Deps...>());
+        return construct<Impl>(dependencies);
+    }
+};
+
+/**
+ * @brief Checks whether a type can be registered with registerType().
+ * @param lifetime The lifetime of the service.
+ * @return True for Transient and LazySingleton.
+ */
+constexpr bool isWiredLifetime(ServiceLifetime lifetime) noexcept {
+    return lifetime == ServiceLifetime::Transient || lifetime == ServiceLifetime::LazySingleton;
+}
+
+/**
+ * @brief Makes the factory of a type registered with registerType().
+ * @tparam T The type of the service.
+ * @tparam Impl The type of the instances.
+ * @tparam Deps The types of the dependencies, in constructor order.
+ * @param contracts The interned contract of each dependency.
+ * @return The factory.
+ */
+template <class T, class Impl, class... Deps>
+ServiceFactory makeWiredFactory(const std::array<ContractId, sizeof...(Deps)> &contracts) {
+    static_assert(std::is_convertible_v<Impl *, T *>, "Impl must be convertible to T");
+    static_assert(std::is_constructible_v<Impl, std::shared_ptr<Deps>...>, "Impl must be constructible from its dependencies");
+
+    return makeFactory<T, Impl>([plans = std::make_shared<WiringPlans<Deps...>>(contracts)] {
+        return plans->template construct<Impl>();
+    });
+}
+}
+
+/**
+ * @brief Registers a type whose constructor dependencies are resolved automatically.
+ *
+ * Impl must be constructible from a std::shared_ptr to each dependency, in
+ * the order given; dependencies that are not registered are passed as
+ * nullptr. Each construction resolves the dependencies through a plan bound
+ * on first use, so building a deep object graph of wired types is a flat
+ * sequence of direct calls through registration entries.
+ * @tparam T The type of the service.
+ * @tparam Impl The type of the instances.
+ * @tparam Deps The types of the dependencies, in constructor order.
+ * @param lifetime The lifetime of the service: Transient or LazySingleton.
+ * @param contracts The interned contract of each dependency, see internContract(); no contract by default.
+ * @return True if the service was registered, false if it was already registered or the lifetime is not supported.
+ */
+template <class T, class Impl, class... Deps>
+bool registerType(ServiceLifetime lifetime = ServiceLifetime::Transient, const std::array<ContractId, sizeof...(Deps)> &contracts = {}) {
+    if (!detail::isWiredLifetime(lifetime)) {
+        return false;
+    }
+
+    return registerFactory(std::type_index(typeid(T)), lifetime, detail::makeWiredFactory<T, Impl, Deps...>(contracts));
+}
+
+/**
+ * @brief Registers a type whose constructor dependencies are resolved automatically, with a contract.
+ * @tparam T The type of the service.
+ * @tparam Impl The type of the instances.
+ * @tparam Deps The types of the dependencies, in constructor order.
+ * @param contract The contract for the service.
+ * @param lifetime The lifetime of the service: Transient or LazySingleton.
+ * @param contracts The interned contract of each dependency, see internContract(); no contract by default.
+ * @return True if the service was registered, false if it was already registered or the lifetime is not supported.
+ */
+template <class T, class Impl, class... Deps>
+bool registerType(const std::string &contract, ServiceLifetime lifetime = ServiceLifetime::Transient, const std::array<ContractId, sizeof...(Deps)> &contracts = {}) {
+    if (!detail::isWiredLifetime(lifetime)) {
+        return false;
+    }
+
+    return registerFactory(std::type_index(typeid(T)), contract, lifetime, detail::makeWiredFactory<T, Impl, Deps...>(contracts));
+}
+}
+#endif // AUTO_WIRING_H
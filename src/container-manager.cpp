@@ -3,28 +3,160 @@
  * @brief Manages the global service container.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 #include "container-manager.h"
 #include "internal/default-services.h"
+#include "internal/epoch.h"
 
 namespace PureIOC {
 namespace {
-    std::mutex g_mutex; ///< Mutex to protect the global container.
-    std::shared_ptr<IServices> g_container; ///< The global service container.
+    /**
+     * @brief A registered container, published to readers through an atomic pointer.
+     */
+    struct Published {
+        std::shared_ptr<IServices> container;
+    };
+
+    /**
+     * @brief A container replaced by registerContainer(), waiting for its readers to leave.
+     */
+    struct Retired {
+        std::uint64_t epoch; ///< The epoch the container was retired in.
+        std::unique_ptr<Published> published;
+    };
+
+    /**
+     * @brief The state shared by the readers and writers of the global container.
+     */
+    struct State {
+        std::mutex mutex; ///< Guards the publication and the retired containers.
+        std::atomic<Published *> published{nullptr}; ///< The registered container.
+        std::atomic<std::size_t> retiredCount{0}; ///< The number of retired containers not yet released.
+        std::vector<Retired> retired; ///< The replaced containers, oldest first.
+
+        ~State() {
+            delete published.load(std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief Gets the state shared by the readers and writers of the global container.
+     * @return The state.
+     */
+    State &state() {
+        static State instance;
+        return instance;
+    }
+
+    std::atomic<std::uint64_t> g_generation{1}; ///< Advanced by invalidateServices(); the high half of the services generation.
+
+    /**
+     * @brief Gets the published container, creating the default container on first use.
+     *
+     * Must be called inside a read section, see internal::enterEpoch().
+     * @param shared The shared state.
+     * @return The published container.
+     */
+    Published &published(State &shared) {
+        if (Published *current = shared.published.load(std::memory_order_acquire)) {
+            return *current;
+        }
+
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        Published *current = shared.published.load(std::memory_order_relaxed);
+        if (!current) {
+            current = new Published{std::make_shared<internal::DefaultServices>()};
+            shared.published.store(current, std::memory_order_release);
+        }
+
+        return *current;
+    }
+
+    /**
+     * @brief Releases the retired containers that no thread can still be reading.
+     *
+     * The containers are destroyed after the lock is released, so their
+     * services may use the locator.
+     */
+    void reclaim() {
+        State &shared = state();
+        std::vector<Retired> released;
+        {
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            auto unused = std::find_if(shared.retired.begin(), shared.retired.end(), [](const Retired &retired) {
+                return !internal::epochReached(retired.epoch);
+            });
+            released.assign(std::make_move_iterator(shared.retired.begin()), std::make_move_iterator(unused));
+            shared.retired.erase(shared.retired.begin(), unused);
+            shared.retiredCount.store(shared.retired.size(), std::memory_order_relaxed);
+        }
+    }
+}
+
+namespace detail {
+std::atomic<std::uint64_t> servicesChanges{1};
+}
+
+ContainerGuard::ContainerGuard() {
+    internal::enterEpoch();
+    _services = published(state()).container.get();
+}
+
+ContainerGuard::~ContainerGuard() {
+    if (internal::leaveEpoch() && state().retiredCount.load(std::memory_order_relaxed)) {
+        reclaim();
+    }
 }
 
 void registerContainer(std::shared_ptr<IServices> services) {
-    std::lock_guard<std::mutex> lock(g_mutex);
-    g_container = services ? std::move(services) : std::make_shared<internal::DefaultServices>();
+    auto replacement = std::make_unique<Published>();
+    replacement->container = services ? std::move(services) : std::make_shared<internal::DefaultServices>();
+
+    State &shared = state();
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        std::unique_ptr<Published> previous(shared.published.exchange(replacement.release(), std::memory_order_acq_rel));
+        if (previous) {
+            shared.retired.push_back(Retired{internal::advanceEpoch(), std::move(previous)});
+            shared.retiredCount.store(shared.retired.size(), std::memory_order_relaxed);
+        }
+    }
+
+    invalidateServices();
+    reclaim();
+}
+
+std::shared_ptr<IServices> makeContainer(const ContainerOptions &options) {
+    return std::make_shared<internal::DefaultServices>(options);
+}
+
+void registerContainer(const ContainerOptions &options) {
+    registerContainer(makeContainer(options));
 }
 
 std::shared_ptr<IServices> getContainer() {
-    std::lock_guard<std::mutex> lock(g_mutex);
-    if (!g_container) {
-        g_container = std::make_shared<internal::DefaultServices>();
-    }
+    ContainerGuard guard;
+    return published(state()).container;
+}
+
+ContainerGuard currentContainer() {
+    return ContainerGuard();
+}
+
+std::uint64_t servicesGeneration() noexcept {
+    const std::uint64_t invalidations = g_generation.load(std::memory_order_acquire);
+    ContainerGuard container;
+    return (invalidations << 32) + container->generation();
+}
 
-    return g_container;
+void invalidateServices() noexcept {
+    g_generation.fetch_add(1, std::memory_order_acq_rel);
+    detail::servicesChanges.fetch_add(1, std::memory_order_acq_rel);
 }
 }
@@ -6,8 +6,11 @@
 #ifndef CONTAINER_MANAGER_H
 #define CONTAINER_MANAGER_H
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <memory>
 
+#include "container-options.h"
 #include "services-interface.h"
 
 namespace PureIOC {
@@ -17,12 +20,116 @@ namespace PureIOC {
      */
     void registerContainer(std::shared_ptr<IServices> services);
 
+    /**
+     * @brief Creates a default service container without registering it.
+     *
+     * Use it for per-module containers, for example a child that sets
+     * ContainerOptions::parent to the global container.
+     * @param options The options of the container.
+     * @return The container.
+     */
+    std::shared_ptr<IServices> makeContainer(const ContainerOptions &options);
+
+    /**
+     * @brief Registers a new default service container created with the given options.
+     * @param options The options of the container.
+     */
+    void registerContainer(const ContainerOptions &options);
+
     /**
      * @brief Gets the registered service container.
      * @return A shared pointer to the service container.
      */
     std::shared_ptr<IServices> getContainer();
 
+    /**
+     * @brief Pins the registered service container for the duration of a call.
+     *
+     * Entering a guard announces the current container epoch in a record owned
+     * by the calling thread and reads the container without locking or
+     * touching its reference count. registerContainer() retires the container
+     * it replaces and releases it as soon as no guard entered before the swap
+     * is still alive, so a replaced container and its singletons are destroyed
+     * once every thread has left the locator. Guards nest; a guard created
+     * from within a factory sees a container registered by that factory.
+     */
+    class ContainerGuard {
+    private:
+        IServices *_services;
+
+    public:
+        /**
+         * @brief Enters the calling thread into the container and pins it.
+         */
+        ContainerGuard();
+        /**
+         * @brief Leaves the container, releasing replaced containers nobody reads any more.
+         */
+        ~ContainerGuard();
+
+        ContainerGuard(const ContainerGuard &) = delete;
+        ContainerGuard &operator=(const ContainerGuard &) = delete;
+
+        /**
+         * @brief Gets the pinned container.
+         * @return The container.
+         */
+        IServices &get() const noexcept {
+            return *_services;
+        }
+
+        IServices &operator*() const noexcept {
+            return *_services;
+        }
+
+        IServices *operator->() const noexcept {
+            return _services;
+        }
+    };
+
+    /**
+     * @brief Gets the registered service container without locking or copying its pointer.
+     *
+     * The container stays pinned while the returned guard is alive, even if
+     * another thread replaces it meanwhile, so use it for a single call:
+     * currentContainer()->getService(type).
+     * @return The guard of the service container.
+     */
+    ContainerGuard currentContainer();
+
+    /**
+     * @brief Gets the current services generation of the registered container.
+     *
+     * The generation changes whenever the container is replaced, when
+     * invalidateServices() is called, or when IServices::generation() of the
+     * registered container changes, that is when a service is registered or
+     * unregistered in it or in one of its ancestors. Registrations in other
+     * containers, such as children created with makeContainer(), leave it
+     * unchanged. It is used to invalidate cached resolutions.
+     * @return The current generation.
+     */
+    std::uint64_t servicesGeneration() noexcept;
+
+    namespace detail {
+        /**
+         * @brief Advanced by invalidateServices() and by every change to a default container.
+         *
+         * Unlike servicesGeneration(), it changes when any container changes,
+         * so a bound ServiceHandle can check it with a single load.
+         */
+        extern std::atomic<std::uint64_t> servicesChanges;
+    }
+
+    /**
+     * @brief Advances the services generation, invalidating cached resolutions.
+     *
+     * Called by registerContainer(). Custom containers that report lifetimes
+     * through IServices::getLifetime() but no IServices::generation(), or
+     * that expose entries through IServices::getEntry(), must call it on
+     * every change.
+     */
+    void invalidateServices() noexcept;
+
     template <class T>
     void registerContainer() {
         static_assert(std::is_convertible_v<T *, IServices *>, "T must be convertible to IServices");
@@ -32,6 +139,20 @@ namespace PureIOC {
         registerContainer(std::move(services));
     }
 
+    /**
+     * @brief Registers a new service container of type T created with the given options.
+     * @tparam T The type of the container, constructible from ContainerOptions.
+     * @param options The options of the container, such as its shard count.
+     */
+    template <class T>
+    void registerContainer(const ContainerOptions &options) {
+        static_assert(std::is_convertible_v<T *, IServices *>, "T must be convertible to IServices");
+        std::shared_ptr<T> container = std::make_shared<T>(options);
+        std::shared_ptr<IServices> services = std::static_pointer_cast<IServices>(std::move(container));
+
+        registerContainer(std::move(services));
+    }
+
     template <class T>
     void registerContainer(std::function<std::shared_ptr<T>()> factory) {
         static_assert(std::is_convertible_v<T *, IServices *>, "T must be convertible to IServices");
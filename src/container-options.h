@@ -0,0 +1,79 @@
+/**
+ * @file container-options.h
+ * @brief This file contains the options of the default service container.
+ */
+
+#ifndef CONTAINER_OPTIONS_H
+#define CONTAINER_OPTIONS_H
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace PureIOC {
+class DependencyRecorder;
+class IServices;
+
+/**
+ * @brief Options for creating the default service container.
+ */
+struct ContainerOptions {
+    /**
+     * @brief Whether registrations are published as immutable snapshots.
+     *
+     * In copy-on-write mode, a registration or unregistration builds a new
+     * lookup table off to the side and publishes it atomically. Lookups read
+     * the current snapshot and never wait for a writer, at the cost of one
+     * table rebuild per change. Use it when services are registered while
+     * traffic flows.
+     */
+    bool copyOnWrite = false;
+
+    /**
+     * @brief The number of independently locked shards the registrations are spread over.
+     *
+     * Each key is hashed to one shard, so concurrent registrations and
+     * lookups of different services rarely contend on the same lock. Use
+     * more than one shard when many services are registered concurrently;
+     * freezing the container locks every shard once.
+     */
+    std::size_t shards = 1;
+
+    /**
+     * @brief The container that services not registered in this one resolve through.
+     *
+     * A child container overrides the services it registers and inherits the
+     * rest. Entries resolved through the parent, and misses, are cached in
+     * the child until the generation of the parent changes, so lookups cost
+     * the same however deep the hierarchy is.
+     */
+    std::shared_ptr<IServices> parent;
+
+    /**
+     * @brief The memory resource the container allocates its registry from.
+     *
+     * Lookup tables, published snapshots and registration entries are all
+     * allocated from it, so the registry can live in a monotonic or
+     * hugepage-backed arena and be released in one go. Nullptr uses the
+     * default resource. The resource must outlive the container and every
+     * service resolved from it.
+     *
+     * The resource must be thread-safe: registrations allocate from it on
+     * the registering threads, lookups through a parent allocate their caches
+     * on the reading threads, and entries are released on whichever thread
+     * drops the last reference. std::pmr::monotonic_buffer_resource is not;
+     * put a std::pmr::synchronized_pool_resource in front of it.
+     */
+    std::pmr::memory_resource *resource = nullptr;
+
+    /**
+     * @brief The recorder that captures the dependency graph of the services, if any.
+     *
+     * Factories registered while a recorder is set are timed, and the
+     * services resolved from within them are recorded as their
+     * dependencies, see DependencyRecorder. Leave it empty in production.
+     */
+    std::shared_ptr<DependencyRecorder> recorder;
+};
+}
+#endif // CONTAINER_OPTIONS_H
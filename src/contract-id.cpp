@@ -0,0 +1,49 @@
+/**
+ * @file contract-id.cpp
+ * @brief Implements the registry of interned contracts.
+ */
+
+#include <string>
+#include <string_view>
+
+#include "contract-id.h"
+#include "internal/intern-table.h"
+
+namespace PureIOC {
+namespace {
+    /**
+     * @brief Gets the registry of interned contracts, indexed by id - 1.
+     *
+     * Lookups read the registry without locking, so resolving a contract
+     * never contends with other readers once it is interned.
+     * @return The registry.
+     */
+    internal::InternTable<std::string, std::string_view> &contracts() {
+        static internal::InternTable<std::string, std::string_view> table;
+        return table;
+    }
+}
+
+ContractId internContract(std::string_view contract) {
+    return ContractId(static_cast<std::uint32_t>(contracts().intern(contract) + 1));
+}
+
+std::optional<ContractId> findContract(std::string_view contract) {
+    std::optional<std::size_t> id = contracts().find(contract);
+    if (!id) {
+        return std::nullopt;
+    }
+
+    return ContractId(static_cast<std::uint32_t>(*id + 1));
+}
+
+const std::string &contractName(ContractId contract) {
+    static const std::string empty;
+    if (!contract) {
+        return empty;
+    }
+
+    const std::string *name = contracts().get(contract.value() - 1);
+    return name ? *name : empty;
+}
+}
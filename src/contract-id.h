@@ -0,0 +1,88 @@
+/**
+ * @file contract-id.h
+ * @brief This file contains the interned identifiers of service contracts.
+ */
+
+#ifndef CONTRACT_ID_H
+#define CONTRACT_ID_H
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace PureIOC {
+/**
+ * @brief A contract interned to a small stable integer.
+ *
+ * Resolving a service by ContractId avoids copying and hashing the contract
+ * string on every lookup. The default-constructed id stands for "no contract".
+ */
+class ContractId {
+private:
+    std::uint32_t _value = 0;
+
+public:
+    /**
+     * @brief Constructs the id that stands for "no contract".
+     */
+    constexpr ContractId() noexcept = default;
+    /**
+     * @brief Constructs an id from its raw value.
+     * @param value The raw value, as returned by value().
+     */
+    constexpr explicit ContractId(std::uint32_t value) noexcept
+        : _value(value) {}
+
+    /**
+     * @brief Gets the raw value of the id.
+     * @return The raw value, zero for "no contract".
+     */
+    constexpr std::uint32_t value() const noexcept {
+        return _value;
+    }
+
+    /**
+     * @brief Checks whether the id names a contract.
+     * @return True unless this is the "no contract" id.
+     */
+    constexpr explicit operator bool() const noexcept {
+        return _value != 0;
+    }
+
+    friend constexpr bool operator==(ContractId a, ContractId b) noexcept {
+        return a._value == b._value;
+    }
+
+    friend constexpr bool operator!=(ContractId a, ContractId b) noexcept {
+        return a._value != b._value;
+    }
+};
+
+/**
+ * @brief Interns a contract, assigning it an id on first use.
+ *
+ * Ids are never released, so intern a fixed set of contracts once and keep
+ * the ids rather than interning arbitrary strings per request.
+ * @param contract The contract.
+ * @return The id of the contract.
+ */
+ContractId internContract(std::string_view contract);
+
+/**
+ * @brief Finds the id of a contract without interning it.
+ *
+ * The lookup takes no lock and neither allocates nor copies the contract.
+ * @param contract The contract.
+ * @return The id of the contract, or std::nullopt if it was never interned.
+ */
+std::optional<ContractId> findContract(std::string_view contract);
+
+/**
+ * @brief Gets the contract an id was interned from.
+ * @param contract The id of the contract.
+ * @return The contract, or an empty string for the "no contract" id.
+ */
+const std::string &contractName(ContractId contract);
+}
+#endif // CONTRACT_ID_H
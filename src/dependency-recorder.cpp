@@ -0,0 +1,427 @@
+/**
+ * @file dependency-recorder.cpp
+ * @brief Implements the recording of the dependency graph built while services are constructed.
+ */
+
+#include "dependency-recorder.h"
+#include "service-slot.h"
+
+#include <algorithm>
+#include <any>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+namespace PureIOC {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief A construction in progress on the current thread.
+ */
+struct Frame {
+    const void *owner;                ///< The recorder that wrapped the factory.
+    std::size_t node;                 ///< The node under construction.
+    Clock::time_point start;          ///< When the factory was entered.
+    std::chrono::nanoseconds nested;  ///< The time spent in nested constructions so far.
+};
+
+thread_local std::vector<Frame> t_frames;
+
+std::string typeName(const std::type_index &type) {
+#if __has_include(<cxxabi.h>)
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    if (demangled) {
+        std::string name(demangled);
+        std::free(demangled);
+        return name;
+    }
+#endif
+    return type.name();
+}
+
+/**
+ * @brief Escapes text for a JSON string.
+ */
+std::string escapeJson(const std::string &text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+        case '"':
+        case '\\':
+            escaped += '\\';
+            escaped += c;
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        case '\r':
+            escaped += "\\r";
+            break;
+        case '\t':
+            escaped += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(c)));
+                escaped += buffer;
+            } else {
+                escaped += c;
+            }
+        }
+    }
+
+    return escaped;
+}
+
+/**
+ * @brief Escapes text for a double-quoted Graphviz label.
+ *
+ * Graphviz has no escape for arbitrary characters, so newlines become
+ * line breaks and other control characters are replaced by '?'.
+ */
+std::string escapeDot(const std::string &text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += '?';
+        } else {
+            escaped += c;
+        }
+    }
+
+    return escaped;
+}
+
+std::string milliseconds(std::chrono::nanoseconds duration) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3f ms", static_cast<double>(duration.count()) / 1e6);
+    return buffer;
+}
+
+std::chrono::nanoseconds weight(const DependencyNode &node) {
+    return node.constructions ? node.exclusive / static_cast<std::int64_t>(node.constructions) : std::chrono::nanoseconds(0);
+}
+
+/**
+ * @brief Computes the heaviest chain of dependencies starting at each node.
+ *
+ * Edges back to a node still being visited would close a cycle and are
+ * ignored.
+ */
+struct Chains {
+    const DependencyGraph &graph;
+    std::vector<int> state;
+    std::vector<std::chrono::nanoseconds> cost;
+    std::vector<std::size_t> next;
+
+    explicit Chains(const DependencyGraph &graph)
+        : graph(graph), state(graph.nodes.size(), 0), cost(graph.nodes.size()), next(graph.nodes.size(), graph.nodes.size()) {
+        for (std::size_t i = 0; i < graph.nodes.size(); ++i) {
+            visit(i);
+        }
+    }
+
+    /**
+     * @brief Finds the heaviest chain from a node and from every node it reaches.
+     *
+     * Depth first, with an explicit stack so that long chains cannot
+     * overflow the call stack. While a node is on the stack, its cost holds
+     * the heaviest of its finished dependencies; its own weight is added when
+     * it is popped.
+     */
+    void visit(std::size_t root) {
+        if (state[root] != 0) {
+            return;
+        }
+
+        std::vector<std::pair<std::size_t, std::size_t>> stack; // The node and its next dependency to visit.
+        state[root] = 1;
+        stack.emplace_back(root, 0);
+        while (!stack.empty()) {
+            const std::size_t node = stack.back().first;
+            const std::vector<std::size_t> &dependencies = graph.nodes[node].dependencies;
+            if (stack.back().second < dependencies.size()) {
+                const std::size_t dependency = dependencies[stack.back().second++];
+                if (state[dependency] == 0) {
+                    state[dependency] = 1;
+                    stack.emplace_back(dependency, 0);
+                } else {
+                    consider(node, dependency);
+                }
+                continue;
+            }
+
+            cost[node] += weight(graph.nodes[node]);
+            state[node] = 2;
+            stack.pop_back();
+            if (!stack.empty()) {
+                consider(stack.back().first, node);
+            }
+        }
+    }
+
+    /**
+     * @brief Follows a dependency from a node on the stack if its chain is the heaviest so far.
+     */
+    void consider(std::size_t node, std::size_t dependency) {
+        if (state[dependency] == 2 && (next[node] == graph.nodes.size() || cost[dependency] > cost[node])) {
+            cost[node] = cost[dependency];
+            next[node] = dependency;
+        }
+    }
+
+    std::vector<std::size_t> path() const {
+        std::vector<std::size_t> nodes;
+        if (graph.nodes.empty()) {
+            return nodes;
+        }
+
+        std::size_t node = static_cast<std::size_t>(std::max_element(cost.begin(), cost.end()) - cost.begin());
+        for (; node != graph.nodes.size(); node = next[node]) {
+            nodes.push_back(node);
+        }
+
+        return nodes;
+    }
+};
+}
+
+namespace detail {
+std::atomic<std::size_t> liveRecorders{0};
+}
+
+struct DependencyRecorder::Impl {
+    using NodeKey = std::pair<std::size_t, std::uint32_t>;
+
+    mutable std::mutex mutex;
+    std::map<NodeKey, std::size_t> indices;
+    std::vector<DependencyNode> nodes;
+
+    Impl() {
+        detail::liveRecorders.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ~Impl() {
+        detail::liveRecorders.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    Impl(const Impl &) = delete;
+    Impl &operator=(const Impl &) = delete;
+
+    /**
+     * @brief Gets the node of a service, adding it if needed. Must be called with the mutex held.
+     */
+    std::size_t nodeOf(std::size_t slot, ContractId contract) {
+        auto [it, inserted] = indices.emplace(NodeKey(slot, contract.value()), nodes.size());
+        if (inserted) {
+            nodes.push_back(DependencyNode{slotType(slot), contract, 0, {}, {}, {}});
+        }
+
+        return it->second;
+    }
+
+    /**
+     * @brief Adds an edge from the service under construction on this thread, if any. Must be called with the mutex held.
+     */
+    void link(std::size_t node) {
+        if (t_frames.empty() || t_frames.back().owner != this) {
+            return;
+        }
+
+        const std::size_t from = t_frames.back().node;
+        if (from == node || from >= nodes.size()) {
+            return;
+        }
+
+        std::vector<std::size_t> &dependencies = nodes[from].dependencies;
+        if (std::find(dependencies.begin(), dependencies.end(), node) == dependencies.end()) {
+            dependencies.push_back(node);
+        }
+    }
+
+    void enter(std::size_t slot, ContractId contract) {
+        std::size_t node;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            node = nodeOf(slot, contract);
+            link(node);
+        }
+
+        t_frames.push_back(Frame{this, node, Clock::now(), std::chrono::nanoseconds(0)});
+    }
+
+    void leave() {
+        const Frame frame = t_frames.back();
+        t_frames.pop_back();
+
+        const auto inclusive = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - frame.start);
+        if (!t_frames.empty()) {
+            t_frames.back().nested += inclusive;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (frame.node < nodes.size()) {
+            DependencyNode &node = nodes[frame.node];
+            ++node.constructions;
+            node.inclusive += inclusive;
+            node.exclusive += inclusive - frame.nested;
+        }
+    }
+
+    /**
+     * @brief Times a factory run for as long as it is alive, exceptions included.
+     */
+    struct Recording {
+        Impl &impl;
+
+        Recording(Impl &impl, std::size_t slot, ContractId contract)
+            : impl(impl) {
+            impl.enter(slot, contract);
+        }
+
+        ~Recording() {
+            impl.leave();
+        }
+    };
+};
+
+DependencyRecorder::DependencyRecorder()
+    : _impl(std::make_shared<Impl>()) {}
+
+DependencyRecorder::~DependencyRecorder() = default;
+
+DependencyGraph DependencyRecorder::graph() const {
+    std::lock_guard<std::mutex> lock(_impl->mutex);
+    return DependencyGraph{_impl->nodes};
+}
+
+void DependencyRecorder::clear() {
+    std::lock_guard<std::mutex> lock(_impl->mutex);
+    _impl->indices.clear();
+    _impl->nodes.clear();
+}
+
+ServiceFactory DependencyRecorder::wrap(std::size_t slot, ContractId contract, ServiceFactory factory) {
+    if (!factory) {
+        return factory;
+    }
+
+    return ServiceFactory([impl = _impl, slot, contract, factory = std::move(factory)]() -> std::any {
+        Impl::Recording recording(*impl, slot, contract);
+        return factory();
+    });
+}
+
+std::function<std::shared_ptr<void>(Scope &)>
+DependencyRecorder::wrap(std::size_t slot, ContractId contract, std::function<std::shared_ptr<void>(Scope &)> factory) {
+    if (!factory) {
+        return factory;
+    }
+
+    return [impl = _impl, slot, contract, factory = std::move(factory)](Scope &scope) {
+        Impl::Recording recording(*impl, slot, contract);
+        return factory(scope);
+    };
+}
+
+void DependencyRecorder::resolved(std::size_t slot, ContractId contract) {
+    if (t_frames.empty() || t_frames.back().owner != _impl.get()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_impl->mutex);
+    _impl->link(_impl->nodeOf(slot, contract));
+}
+
+std::vector<std::size_t> DependencyGraph::criticalPath() const {
+    return Chains(*this).path();
+}
+
+std::chrono::nanoseconds DependencyGraph::criticalPathDuration() const {
+    std::chrono::nanoseconds duration(0);
+    for (std::size_t node : criticalPath()) {
+        duration += weight(nodes[node]);
+    }
+
+    return duration;
+}
+
+std::string DependencyGraph::toDot() const {
+    const std::vector<std::size_t> path = criticalPath();
+    std::vector<bool> critical(nodes.size(), false);
+    for (std::size_t node : path) {
+        critical[node] = true;
+    }
+    auto onPath = [&](std::size_t from, std::size_t to) {
+        auto it = std::find(path.begin(), path.end(), from);
+        return it != path.end() && it + 1 != path.end() && *(it + 1) == to;
+    };
+
+    std::string dot = "digraph services {\n    node [shape=box];\n";
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const DependencyNode &node = nodes[i];
+        std::string label = escapeDot(typeName(node.type));
+        if (node.contract) {
+            label += " (" + escapeDot(contractName(node.contract)) + ")";
+        }
+        label += "\\nself " + milliseconds(node.exclusive) + ", total " + milliseconds(node.inclusive) + ", built " + std::to_string(node.constructions) + "x";
+
+        dot += "    n" + std::to_string(i) + " [label=\"" + label + "\"";
+        dot += critical[i] ? ", color=red];\n" : "];\n";
+    }
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        for (std::size_t dependency : nodes[i].dependencies) {
+            dot += "    n" + std::to_string(i) + " -> n" + std::to_string(dependency);
+            dot += onPath(i, dependency) ? " [color=red];\n" : ";\n";
+        }
+    }
+    dot += "}\n";
+
+    return dot;
+}
+
+std::string DependencyGraph::toJson() const {
+    auto list = [](const std::vector<std::size_t> &values) {
+        std::string json = "[";
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            json += (i ? "," : "") + std::to_string(values[i]);
+        }
+        return json + "]";
+    };
+
+    std::string json = "{\"nodes\":[";
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const DependencyNode &node = nodes[i];
+        json += i ? "," : "";
+        json += "{\"id\":" + std::to_string(i);
+        json += ",\"type\":\"" + escapeJson(typeName(node.type)) + "\"";
+        json += ",\"contract\":\"" + escapeJson(contractName(node.contract)) + "\"";
+        json += ",\"constructions\":" + std::to_string(node.constructions);
+        json += ",\"inclusiveNs\":" + std::to_string(node.inclusive.count());
+        json += ",\"exclusiveNs\":" + std::to_string(node.exclusive.count());
+        json += ",\"dependencies\":" + list(node.dependencies) + "}";
+    }
+    json += "],\"criticalPath\":" + list(criticalPath());
+    json += ",\"criticalPathNs\":" + std::to_string(criticalPathDuration().count()) + "}";
+
+    return json;
+}
+}
@@ -0,0 +1,148 @@
+/**
+ * @file dependency-recorder.h
+ * @brief This file contains the recording of the dependency graph built while services are constructed.
+ */
+
+#ifndef DEPENDENCY_RECORDER_H
+#define DEPENDENCY_RECORDER_H
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+#include "contract-id.h"
+#include "service-factory.h"
+
+namespace PureIOC {
+class Scope;
+
+namespace detail {
+/**
+ * @brief The number of recorders alive; ServiceHandle keeps no entry while it is not zero.
+ */
+extern std::atomic<std::size_t> liveRecorders;
+}
+
+/**
+ * @brief A service seen by a DependencyRecorder.
+ */
+struct DependencyNode {
+    std::type_index type;                  ///< The type of the service.
+    ContractId contract;                   ///< The interned contract of the service.
+    std::size_t constructions = 0;         ///< The number of times its factory ran.
+    std::chrono::nanoseconds inclusive{0}; ///< The time spent in its factory, nested constructions included.
+    std::chrono::nanoseconds exclusive{0}; ///< The time spent in its factory, nested constructions excluded.
+    std::vector<std::size_t> dependencies; ///< The nodes resolved from within its factory.
+};
+
+/**
+ * @brief The dependency graph captured by a DependencyRecorder.
+ */
+struct DependencyGraph {
+    std::vector<DependencyNode> nodes; ///< The services, indexed by the dependencies of each node.
+
+    /**
+     * @brief Finds the critical path of the graph.
+     *
+     * Each node weighs the mean time its factory spent outside nested
+     * constructions. The critical path is the heaviest chain of dependencies:
+     * with every independent construction run in parallel, startup still
+     * takes at least as long as this chain. Its services are the ones worth
+     * making faster or deferring.
+     * @return The nodes of the path, each depending on the next.
+     */
+    std::vector<std::size_t> criticalPath() const;
+
+    /**
+     * @brief Gets the duration of the critical path.
+     * @return The sum of the weights of its nodes.
+     */
+    std::chrono::nanoseconds criticalPathDuration() const;
+
+    /**
+     * @brief Renders the graph in the Graphviz DOT language.
+     *
+     * Edges point from a service to its dependencies; the nodes and edges
+     * of the critical path are drawn in red.
+     * @return The DOT source.
+     */
+    std::string toDot() const;
+
+    /**
+     * @brief Renders the graph as JSON.
+     * @return An object with the nodes, the critical path and its duration in nanoseconds.
+     */
+    std::string toJson() const;
+};
+
+/**
+ * @brief Records which services are resolved from within which factories, and how long each factory takes.
+ *
+ * Set a recorder in ContainerOptions::recorder to have the default container
+ * record the bootstrap: every factory it registers is wrapped so that its
+ * runs are timed, and every resolution made from within a running factory
+ * adds an edge from the service under construction to the resolved service.
+ * Nested constructions are tracked per thread, so services constructed
+ * concurrently, by warmUp() for instance, are attributed correctly.
+ * While a recorder is alive, ServiceHandle objects, and so auto-wired
+ * dependencies, resolve through the container, so that every resolution
+ * is recorded.
+ *
+ * Recording takes a lock on every construction and on every resolution made
+ * from within a factory; leave it off in production.
+ */
+class DependencyRecorder final {
+private:
+    struct Impl;
+    std::shared_ptr<Impl> _impl; ///< Shared with the wrapped factories, which may outlive the recorder.
+
+public:
+    DependencyRecorder();
+    ~DependencyRecorder();
+
+    DependencyRecorder(const DependencyRecorder &) = delete;
+    DependencyRecorder &operator=(const DependencyRecorder &) = delete;
+
+    /**
+     * @brief Gets a copy of the graph recorded so far.
+     * @return The graph.
+     */
+    DependencyGraph graph() const;
+
+    /**
+     * @brief Forgets everything recorded so far.
+     */
+    void clear();
+
+    /**
+     * @brief Wraps a factory so that its runs are recorded.
+     * @param slot The slot of the type of the service.
+     * @param contract The interned contract of the service.
+     * @param factory The factory.
+     * @return The wrapped factory, or an empty factory if factory is empty.
+     */
+    ServiceFactory wrap(std::size_t slot, ContractId contract, ServiceFactory factory);
+
+    /**
+     * @brief Wraps the factory of a scoped service so that its runs are recorded.
+     * @param slot The slot of the type of the service.
+     * @param contract The interned contract of the service.
+     * @param factory The factory.
+     * @return The wrapped factory, or an empty function if factory is empty.
+     */
+    std::function<std::shared_ptr<void>(Scope &)> wrap(std::size_t slot, ContractId contract, std::function<std::shared_ptr<void>(Scope &)> factory);
+
+    /**
+     * @brief Records a resolution, as a dependency of the service under construction on this thread, if any.
+     * @param slot The slot of the type of the resolved service.
+     * @param contract The interned contract of the resolved service.
+     */
+    void resolved(std::size_t slot, ContractId contract);
+};
+}
+#endif // DEPENDENCY_RECORDER_H
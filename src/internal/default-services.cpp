@@ -5,27 +5,47 @@
 
 #include "internal/default-services.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include <container-manager.h>
+#include <contract-id.h>
+#include <dependency-recorder.h>
+#include <internal/epoch.h>
 #include <locator.h>
 #include <logger-interface.h>
+#include <service-entry.h>
+#include <service-slot.h>
 
 namespace {
 
+using ::PureIOC::ServiceEntry;
+
+/**
+ * @brief A key made of a type slot and an interned contract id, zero for no contract.
+ */
+using Key = std::pair<std::size_t, std::uint32_t>;
+
 /**
  * @struct PairHash
- * @brief A hash function for pairs of type_index and optional string.
+ * @brief A hash function for pairs of type slot and contract id.
  */
 struct PairHash {
-    using is_transparent = void;
-
-    size_t operator()(const std::pair<std::type_index, std::optional<std::string>> &v) const noexcept {
-        const size_t h1 = std::hash<std::type_index>{}(v.first);
-        const size_t h2 = !v.second ? 0x9e3779b97f4a7c15ull : std::hash<std::string>{}(*v.second);
+    size_t operator()(const Key &v) const noexcept {
+        const size_t h1 = std::hash<std::size_t>{}(v.first);
+        const size_t h2 = !v.second ? 0x9e3779b97f4a7c15ull : std::hash<std::uint32_t>{}(v.second);
 
         return h1 ^ (h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2));
     }
@@ -33,78 +53,731 @@ struct PairHash {
 
 /**
  * @struct PairEq
- * @brief An equality function for pairs of type_index and optional string.
+ * @brief An equality function for pairs of type slot and contract id.
  */
 struct PairEq {
-    bool operator()(const std::pair<std::type_index, std::optional<std::string>> &a,
-        const std::pair<std::type_index, std::optional<std::string>> &b) const noexcept {
-
+    bool operator()(const Key &a, const Key &b) const noexcept {
         return a.first == b.first && a.second == b.second;
     }
 };
 
-using ContractKey = std::optional<std::string>;
-using Key = std::pair<std::type_index, ContractKey>;
-
 /**
  * @brief A type alias for an unordered map with a Key, a value, a PairHash, and a PairEq.
  * @tparam V The value type.
  */
 template <class V>
-using Map = std::unordered_map<Key, V, PairHash, PairEq>;
+using Map = std::pmr::unordered_map<Key, V, PairHash, PairEq>;
+
+/**
+ * @class Table
+ * @brief Stores values by key, keeping uncontracted keys in a flat array indexed by type slot.
+ * @tparam V The value type.
+ */
+template <class V>
+class Table {
+private:
+    std::pmr::vector<std::optional<V>> _slots;
+    Map<V> _contracted;
+
+public:
+    /**
+     * @brief Constructs an empty table.
+     * @param resource The memory resource the table allocates from.
+     */
+    explicit Table(std::pmr::memory_resource *resource)
+        : _slots(resource), _contracted(resource) {}
+
+    /**
+     * @brief Finds the value for a key.
+     * @param key The key.
+     * @return A pointer to the value, or nullptr if not found.
+     */
+    const V *find(const Key &key) const {
+        if (!key.second) {
+            return key.first < _slots.size() && _slots[key.first] ? &*_slots[key.first] : nullptr;
+        }
+
+        auto it = _contracted.find(key);
+        return it != _contracted.end() ? &it->second : nullptr;
+    }
+
+    /**
+     * @brief Gets the value for a key, default-constructing it if missing.
+     * @param key The key.
+     * @return A reference to the value.
+     */
+    V &operator[](const Key &key) {
+        if (key.second) {
+            return _contracted[key];
+        }
+
+        if (key.first >= _slots.size()) {
+            _slots.resize(key.first + 1);
+        }
+
+        auto &slot = _slots[key.first];
+        if (!slot) {
+            slot.emplace();
+        }
+
+        return *slot;
+    }
+
+    /**
+     * @brief Reserves room for more values.
+     * @param slots The number of type slots to make room for.
+     * @param contracted The number of contracted keys about to be added.
+     */
+    void reserve(std::size_t slots, std::size_t contracted) {
+        if (slots > _slots.size()) {
+            _slots.resize(slots);
+        }
+        _contracted.reserve(_contracted.size() + contracted);
+    }
+
+    /**
+     * @brief Erases the value for a key.
+     * @param key The key.
+     */
+    void erase(const Key &key) {
+        if (key.second) {
+            _contracted.erase(key);
+        } else if (key.first < _slots.size()) {
+            _slots[key.first].reset();
+        }
+    }
+
+    /**
+     * @brief Calls a function for every stored key and value.
+     * @param f The function, called as f(key, value).
+     */
+    template <class F>
+    void forEach(F &&f) const {
+        for (std::size_t slot = 0; slot < _slots.size(); ++slot) {
+            if (_slots[slot]) {
+                f(Key(slot, 0), *_slots[slot]);
+            }
+        }
+        for (const auto &[key, value] : _contracted) {
+            f(key, value);
+        }
+    }
+};
+
+/**
+ * @struct FrozenEntry
+ * @brief A registration compiled into a FrozenTable.
+ */
+struct FrozenEntry {
+    Key key;
+    std::shared_ptr<ServiceEntry> entry;
+};
+
+/**
+ * @class FrozenTable
+ * @brief An immutable lookup table compiled from the registrations.
+ *
+ * All entries live in one contiguous array. Uncontracted keys are indexed
+ * directly by type slot; contracted keys use open addressing at no more than
+ * half load. The table is never modified once built, so lookups take no lock.
+ * It serves lookups once the container is frozen, and as the published
+ * snapshot of the registrations in copy-on-write mode.
+ */
+class FrozenTable {
+private:
+    std::pmr::vector<FrozenEntry> _entries;
+    std::pmr::vector<std::uint32_t> _slots;   ///< Entry index + 1 per type slot, 0 if empty.
+    std::pmr::vector<std::uint32_t> _buckets; ///< Entry index + 1 per bucket, 0 if empty.
+
+public:
+    /**
+     * @brief Builds the table in the memory resource of its entries.
+     * @param entries The entries, with unique keys.
+     */
+    explicit FrozenTable(std::pmr::vector<FrozenEntry> entries)
+        : _entries(std::move(entries)),
+          _slots(_entries.get_allocator()),
+          _buckets(_entries.get_allocator()) {
+        std::size_t contracted = 0;
+        for (const auto &entry : _entries) {
+            if (entry.key.second) {
+                ++contracted;
+            } else if (entry.key.first >= _slots.size()) {
+                _slots.resize(entry.key.first + 1, 0);
+            }
+        }
+
+        std::size_t buckets = 1;
+        while (buckets < contracted * 2) {
+            buckets <<= 1;
+        }
+        _buckets.assign(contracted ? buckets : 0, 0);
+
+        for (std::size_t i = 0; i < _entries.size(); ++i) {
+            const Key &key = _entries[i].key;
+            const auto index = static_cast<std::uint32_t>(i + 1);
+            if (!key.second) {
+                _slots[key.first] = index;
+                continue;
+            }
+
+            std::size_t bucket = PairHash{}(key) & (_buckets.size() - 1);
+            while (_buckets[bucket]) {
+                bucket = (bucket + 1) & (_buckets.size() - 1);
+            }
+            _buckets[bucket] = index;
+        }
+    }
+
+    /**
+     * @brief Finds the entry for a key.
+     * @param key The key.
+     * @return A pointer to the entry, or nullptr if not found.
+     */
+    const std::shared_ptr<ServiceEntry> *find(const Key &key) const {
+        if (!key.second) {
+            const std::uint32_t index = key.first < _slots.size() ? _slots[key.first] : 0;
+            return index ? &_entries[index - 1].entry : nullptr;
+        }
+
+        if (_buckets.empty()) {
+            return nullptr;
+        }
+
+        const std::size_t mask = _buckets.size() - 1;
+        for (std::size_t bucket = PairHash{}(key) & mask; _buckets[bucket]; bucket = (bucket + 1) & mask) {
+            const FrozenEntry &entry = _entries[_buckets[bucket] - 1];
+            if (PairEq{}(entry.key, key)) {
+                return &entry.entry;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Calls a function for every entry.
+     * @param f The function, called as f(key, entry).
+     */
+    template <class F>
+    void forEach(F &&f) const {
+        for (const FrozenEntry &entry : _entries) {
+            f(entry.key, entry.entry);
+        }
+    }
+};
+
+/**
+ * @struct RetiredTable
+ * @brief A published table replaced while readers may still hold it.
+ * @tparam T The type of the table.
+ */
+template <class T>
+struct RetiredTable {
+    std::uint64_t epoch; ///< The epoch the table was retired in, see PureIOC::internal::advanceEpoch().
+    std::shared_ptr<const T> table;
+};
+
+/**
+ * @brief Releases the retired tables that no reader can still hold.
+ * @param retired The retired tables, oldest first.
+ */
+template <class T>
+void releaseRetired(std::pmr::vector<RetiredTable<T>> &retired) {
+    auto unused = std::find_if(retired.begin(), retired.end(), [](const RetiredTable<T> &table) {
+        return !::PureIOC::internal::epochReached(table.epoch);
+    });
+    retired.erase(retired.begin(), unused);
+}
+
+/**
+ * @class InheritedTable
+ * @brief The entries a child container resolved through its parent, in one generation of the parent.
+ *
+ * A null entry records a service the parent does not expose. Entries are
+ * only ever added, by one writer at a time, into nodes reserved up front,
+ * and published through atomic buckets, so lookups take no lock. A full
+ * table is replaced by a larger copy.
+ */
+class InheritedTable {
+private:
+    struct Node {
+        Key key;
+        std::shared_ptr<ServiceEntry> entry;
+    };
+
+    const std::uint64_t _generation;
+    std::pmr::vector<Node> _nodes;                         ///< Reserved up front, filled in order.
+    std::pmr::vector<std::atomic<std::uint32_t>> _buckets; ///< Node index + 1 per bucket, 0 if empty.
+    std::size_t _size = 0;                                 ///< The number of nodes filled, only read by writers.
+
+public:
+    /**
+     * @brief Builds an empty table.
+     * @param generation The generation of the parent the entries are resolved in.
+     * @param capacity The number of entries the table holds, a power of two.
+     * @param resource The memory resource the table allocates from.
+     */
+    InheritedTable(std::uint64_t generation, std::size_t capacity, std::pmr::memory_resource *resource)
+        : _generation(generation), _nodes(capacity, resource), _buckets(capacity * 2, resource) {}
+
+    std::uint64_t generation() const noexcept {
+        return _generation;
+    }
+
+    std::size_t capacity() const noexcept {
+        return _nodes.size();
+    }
+
+    bool full() const noexcept {
+        return _size == _nodes.size();
+    }
+
+    /**
+     * @brief Finds the entry for a key.
+     * @param key The key.
+     * @return A pointer to the entry, null if the parent exposes none, or nullptr if the key was not resolved yet.
+     */
+    const std::shared_ptr<ServiceEntry> *find(const Key &key) const noexcept {
+        const std::size_t mask = _buckets.size() - 1;
+        for (std::size_t bucket = PairHash{}(key) & mask;; bucket = (bucket + 1) & mask) {
+            const std::uint32_t index = _buckets[bucket].load(std::memory_order_acquire);
+            if (!index) {
+                return nullptr;
+            }
+
+            const Node &node = _nodes[index - 1];
+            if (PairEq{}(node.key, key)) {
+                return &node.entry;
+            }
+        }
+    }
+
+    /**
+     * @brief Adds the entry for a key.
+     *
+     * Must be called by one writer at a time, on a table that is not full
+     * and does not hold the key.
+     * @param key The key.
+     * @param entry The entry, or nullptr if the parent exposes none.
+     */
+    void add(const Key &key, std::shared_ptr<ServiceEntry> entry) noexcept {
+        const auto index = static_cast<std::uint32_t>(_size + 1);
+        _nodes[_size++] = Node{key, std::move(entry)};
+
+        const std::size_t mask = _buckets.size() - 1;
+        std::size_t bucket = PairHash{}(key) & mask;
+        while (_buckets[bucket].load(std::memory_order_relaxed)) {
+            bucket = (bucket + 1) & mask;
+        }
+        _buckets[bucket].store(index, std::memory_order_release);
+    }
+
+    /**
+     * @brief Adds every entry of the table to another table.
+     * @param table The table, with room for the entries.
+     */
+    void copyTo(InheritedTable &table) const noexcept {
+        for (std::size_t i = 0; i < _size; ++i) {
+            table.add(_nodes[i].key, _nodes[i].entry);
+        }
+    }
+};
+
+/**
+ * @class PresenceFilter
+ * @brief Counts the registered keys per bucket, so most misses need no lock.
+ *
+ * A key whose bucket count is zero is certainly not registered, and the
+ * lookup returns without touching the table or its lock. Counts are only
+ * changed by writers, under the lock of the shard holding the key.
+ */
+class PresenceFilter {
+private:
+    static constexpr std::size_t BucketBits = 11;
+    std::array<std::atomic<std::uint32_t>, std::size_t(1) << BucketBits> _counts{};
+
+    static std::size_t bucket(const Key &key) noexcept {
+        const std::uint64_t hash = static_cast<std::uint64_t>(PairHash{}(key)) * 0x9e3779b97f4a7c15ULL;
+        return static_cast<std::size_t>(hash >> (64 - BucketBits));
+    }
+
+public:
+    /**
+     * @brief Checks whether a key may be registered.
+     * @param key The key.
+     * @return False if the key is certainly not registered.
+     */
+    bool mayContain(const Key &key) const noexcept {
+        return _counts[bucket(key)].load(std::memory_order_acquire) != 0;
+    }
+
+    /**
+     * @brief Records a registered key.
+     * @param key The key.
+     */
+    void add(const Key &key) noexcept {
+        _counts[bucket(key)].fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Records an unregistered key.
+     * @param key The key.
+     */
+    void remove(const Key &key) noexcept {
+        _counts[bucket(key)].fetch_sub(1, std::memory_order_release);
+    }
+};
+
+/**
+ * @brief Builds the key of a service with a contract, interning the contract.
+ * @param type The type of the service.
+ * @param contract The contract.
+ * @return The key.
+ */
+Key internKey(const std::type_index &type, std::string_view contract) {
+    return Key(::PureIOC::typeSlot(type), ::PureIOC::internContract(contract).value());
+}
+
+/**
+ * @brief Finds the key of a service with a contract without interning the contract.
+ * @param type The type of the service.
+ * @param contract The contract.
+ * @return The key, or std::nullopt if the contract was never interned and so cannot be registered.
+ */
+std::optional<Key> findKey(const std::type_index &type, std::string_view contract) {
+    std::optional<::PureIOC::ContractId> id = ::PureIOC::findContract(contract);
+    return id ? std::optional<Key>(Key(::PureIOC::typeSlot(type), id->value())) : std::nullopt;
+}
 
 } // namespace
 
 namespace PureIOC::internal {
+/**
+ * @struct Shard
+ * @brief A share of the registrations of a container, with its own lock.
+ *
+ * Shards are aligned to a cache line, so registrations and lookups in
+ * different shards never contend on the same lock or line.
+ */
+struct alignas(64) Shard {
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    mutable std::shared_mutex mutex; ///< Guards entries, table and retired; in copy-on-write mode, only writers take it.
+    Table<std::shared_ptr<ServiceEntry>> entries;
+    std::atomic<const FrozenTable *> snapshot{nullptr}; ///< The published registrations in copy-on-write mode.
+    std::shared_ptr<const FrozenTable> table; ///< Owns the published snapshot.
+    std::pmr::vector<RetiredTable<FrozenTable>> retired; ///< Replaced snapshots, released once no reader can hold them.
+
+    explicit Shard(const allocator_type &allocator)
+        : entries(allocator.resource()), retired(allocator) {}
+};
+
+/**
+ * @struct InheritedCache
+ * @brief The entries, and the misses, a child container resolved through its parent.
+ *
+ * The table is replaced whenever the generation of the parent changes, which
+ * covers registrations anywhere above the child but not in the child itself
+ * or in its siblings, so a hit costs a single probe however deep the
+ * hierarchy is. Readers find the table through a raw pointer inside an
+ * epoch-protected read section and take no lock.
+ */
+struct InheritedCache {
+    std::mutex mutex; ///< Serializes writers.
+    std::atomic<const InheritedTable *> table{nullptr}; ///< The published table.
+    std::shared_ptr<InheritedTable> current; ///< Owns the published table.
+    std::pmr::vector<RetiredTable<InheritedTable>> retired; ///< Replaced tables, released once no reader can hold them.
+
+    explicit InheritedCache(std::pmr::memory_resource *resource)
+        : retired(resource) {}
+};
+
 struct DefaultServices::Impl {
-    mutable std::shared_mutex mutex;
-    mutable Map<std::any> services;
-    mutable Map<std::function<std::any()>> singleton_factories;
-    mutable Map<std::shared_ptr<std::once_flag>> singleton_once_flags;
-    mutable Map<std::function<std::any()>> factories;
+    std::pmr::memory_resource *const resource; ///< Backs the tables, snapshots and entries of the container.
+    std::pmr::vector<Shard> shards;
+    std::shared_ptr<const FrozenTable> frozen_table;
+    std::atomic<const FrozenTable *> frozen{nullptr};
+    const bool copy_on_write;
+    const std::shared_ptr<IServices> parent; ///< The container unresolved services fall back to, if any.
+    PresenceFilter present; ///< The keys registered in this container.
+    mutable InheritedCache inherited;
+    const std::shared_ptr<DependencyRecorder> recorder; ///< Records the dependency graph, if set.
+    std::atomic<std::uint64_t> version{1}; ///< Advanced on every change to the registrations of this container.
+    std::atomic<std::uint64_t> publishes_begun{0}; ///< Snapshot publications started, in copy-on-write mode.
+    std::atomic<std::uint64_t> publishes_done{0};  ///< Snapshot publications finished, in copy-on-write mode.
+
+    /**
+     * @brief Advances the version of the container, and the changes bound service handles check.
+     */
+    void changed() noexcept {
+        version.fetch_add(1, std::memory_order_release);
+        detail::servicesChanges.fetch_add(1, std::memory_order_release);
+    }
 
-    std::optional<std::any> getService(const Key &key);
-    std::optional<std::any> getLazySingleton(const Key &key);
-    std::optional<std::any> getRegisteredConstant(const Key &key) const;
-    std::optional<std::any> getRegisteredFactory(const Map<std::function<std::any()>> &map, const Key &key) const;
+    explicit Impl(const ContainerOptions &options)
+        : resource(options.resource ? options.resource : std::pmr::get_default_resource()),
+          shards(std::max<std::size_t>(options.shards, 1), resource),
+          copy_on_write(options.copyOnWrite),
+          parent(options.parent),
+          inherited(resource),
+          recorder(options.recorder) {
+        if (copy_on_write) {
+            for (Shard &shard : shards) {
+                shard.table = makeTable(std::pmr::vector<FrozenEntry>(resource));
+                shard.snapshot.store(shard.table.get(), std::memory_order_release);
+            }
+        }
+    }
+
+    /**
+     * @brief Creates a registration entry in the memory resource of the container.
+     * @param args The arguments of the entry constructor.
+     * @return The entry.
+     */
+    template <class... Args>
+    std::shared_ptr<ServiceEntry> allocateEntry(Args &&...args) const {
+        return std::allocate_shared<ServiceEntry>(std::pmr::polymorphic_allocator<ServiceEntry>(resource), std::forward<Args>(args)...);
+    }
 
-    template <class T>
-    bool registerService(Map<T> &map, const Key &key, T value) {
-        std::unique_lock<std::shared_mutex> lock(mutex);
-        if (map.find(key) == map.end()) {
-            map[key] = std::move(value);
-            return true;
+    /**
+     * @brief Creates the registration entry of a service, recording its factory if a recorder is set.
+     * @param key The key of the service.
+     * @param lifetime The lifetime of the service.
+     * @param factory The factory, empty for a constant.
+     * @param instance The instance of a constant, empty otherwise.
+     * @return The entry.
+     */
+    std::shared_ptr<ServiceEntry> makeEntry(const Key &key, ServiceLifetime lifetime, ServiceFactory factory, std::any instance) const {
+        if (recorder) {
+            factory = recorder->wrap(key.first, ContractId(key.second), std::move(factory));
         }
 
-        auto logger = ::PureIOC::getService<::PureIOC::ILogger>();
-        if (logger) {
-            logger->warn<DefaultServices>("Service is already registered with contract");
+        return allocateEntry(lifetime, std::move(factory), std::move(instance));
+    }
+
+    /**
+     * @brief Creates the registration entry of a scoped service, recording its factory if a recorder is set.
+     * @param key The key of the service.
+     * @param factory The factory.
+     * @return The entry.
+     */
+    std::shared_ptr<ServiceEntry> makeEntry(const Key &key, std::function<std::shared_ptr<void>(Scope &)> factory) const {
+        if (recorder) {
+            factory = recorder->wrap(key.first, ContractId(key.second), std::move(factory));
         }
 
-        return false;
+        return allocateEntry(std::move(factory));
     }
 
-    bool registerLazySingleton(const Key &key, std::function<std::any()> factory) {
-        std::unique_lock<std::shared_mutex> lock(mutex);
-        if (singleton_factories.find(key) == singleton_factories.end()) {
-            singleton_factories[key] = std::move(factory);
-            singleton_once_flags[key] = std::make_shared<std::once_flag>();
-            return true;
+    /**
+     * @brief Records a resolution as a dependency of the service under construction, if a recorder is set.
+     * @param key The key of the resolved service.
+     */
+    void recordResolution(const Key &key) const {
+        if (recorder) {
+            recorder->resolved(key.first, ContractId(key.second));
         }
+    }
+
+    /**
+     * @brief Creates an immutable table in the memory resource of the container.
+     * @param compiled The entries of the table.
+     * @return The table.
+     */
+    std::shared_ptr<const FrozenTable> makeTable(std::pmr::vector<FrozenEntry> compiled) const {
+        return std::allocate_shared<FrozenTable>(std::pmr::polymorphic_allocator<FrozenTable>(resource), std::move(compiled));
+    }
 
+    /**
+     * @brief Gets the shard holding a key.
+     * @param key The key.
+     * @return The shard.
+     */
+    Shard &shardOf(const Key &key) {
+        return shards.size() == 1 ? shards.front() : shards[PairHash{}(key) % shards.size()];
+    }
+
+    const Shard &shardOf(const Key &key) const {
+        return shards.size() == 1 ? shards.front() : shards[PairHash{}(key) % shards.size()];
+    }
+
+    std::optional<std::any> getService(const Key &key, const std::type_index &type) const;
+    void getServices(const ServiceRequest *requests, std::optional<std::any> *results, std::size_t count) const;
+    void findOwnEntries(const ServiceRequest *requests, std::shared_ptr<ServiceEntry> *entries, std::size_t count) const;
+
+    /**
+     * @brief Resolves the service held by an entry.
+     * @param entry The entry.
+     * @return The service, or std::nullopt for a scoped service, which only resolves through a scope.
+     */
+    static std::optional<std::any> resolve(ServiceEntry &entry) {
+        std::any service = entry.resolve();
+        return service.has_value() ? std::optional<std::any>(std::move(service)) : std::nullopt;
+    }
+    std::optional<ServiceLifetime> getLifetime(const Key &key, const std::type_index &type) const;
+    std::shared_ptr<ServiceEntry> findEntry(const Key &key, const std::type_index &type) const;
+    std::shared_ptr<ServiceEntry> findOwnEntry(const Key &key) const;
+    std::optional<std::shared_ptr<ServiceEntry>> findInheritedEntry(const Key &key, const std::type_index &type) const;
+
+    /**
+     * @brief Caches the entry of a service resolved through the parent.
+     *
+     * Entries resolved in an older generation than the cached one are
+     * dropped; a newer generation replaces the table.
+     * @param key The key.
+     * @param entry The entry, or nullptr if the parent exposes none.
+     * @param generation The generation of the parent the entry was resolved in.
+     */
+    void cacheInherited(const Key &key, std::shared_ptr<ServiceEntry> entry, std::uint64_t generation) const {
+        constexpr std::size_t InitialCapacity = 16;
+
+        std::lock_guard<std::mutex> lock(inherited.mutex);
+        InheritedTable *table = inherited.current.get();
+        const bool same = table && table->generation() == generation;
+        if (table && table->generation() > generation) {
+            return;
+        }
+        if (same && table->find(key)) {
+            return;
+        }
+        if (same && !table->full()) {
+            table->add(key, std::move(entry));
+            return;
+        }
+
+        auto replacement = std::allocate_shared<InheritedTable>(std::pmr::polymorphic_allocator<InheritedTable>(resource),
+                                                                generation, same ? table->capacity() * 2 : InitialCapacity, resource);
+        if (same) {
+            table->copyTo(*replacement);
+        }
+        replacement->add(key, std::move(entry));
+        inherited.table.store(replacement.get(), std::memory_order_release);
+        inherited.current.swap(replacement);
+        if (replacement) {
+            inherited.retired.push_back(RetiredTable<InheritedTable>{advanceEpoch(), std::move(replacement)});
+        }
+        releaseRetired(inherited.retired);
+    }
+    const std::any *borrowService(const Key &key, const std::type_index &type) const;
+
+    /**
+     * @brief Compiles the registrations of a shard into the entries of an immutable table.
+     *
+     * The table shares its entries with the mutable table, so a lazy
+     * singleton that is already constructed, or under construction, is never
+     * built twice. Must be called with the mutex of the shard held.
+     * @param shard The shard.
+     * @param compiled The entries to append to.
+     */
+    static void compile(const Shard &shard, std::pmr::vector<FrozenEntry> &compiled) {
+        shard.entries.forEach([&](const Key &key, const std::shared_ptr<ServiceEntry> &entry) {
+            compiled.push_back(FrozenEntry{key, entry});
+        });
+    }
+
+    /**
+     * @brief Replaces the published snapshot of a shard.
+     *
+     * Must be called with the mutex of the shard held. Readers find the
+     * snapshot through a raw pointer inside an epoch-protected read section,
+     * so the previous snapshot is retired rather than released, and is
+     * released by a later publication once no reader can hold it.
+     * @param shard The shard.
+     */
+    void replaceSnapshot(Shard &shard) const {
+        std::pmr::vector<FrozenEntry> compiled(resource);
+        compile(shard, compiled);
+        std::shared_ptr<const FrozenTable> table = makeTable(std::move(compiled));
+        shard.snapshot.store(table.get(), std::memory_order_release);
+        shard.table.swap(table);
+        shard.retired.push_back(RetiredTable<FrozenTable>{advanceEpoch(), std::move(table)});
+        releaseRetired(shard.retired);
+    }
+
+    /**
+     * @brief Publishes a new snapshot of a shard in copy-on-write mode.
+     *
+     * Must be called with the mutex of the shard held.
+     * @param shard The shard.
+     */
+    void publish(Shard &shard) {
+        if (!copy_on_write) {
+            return;
+        }
+
+        publishes_begun.fetch_add(1, std::memory_order_acq_rel);
+        replaceSnapshot(shard);
+        publishes_done.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Publishes new snapshots of several shards in copy-on-write mode, as one change.
+     *
+     * Must be called with the mutexes of the shards held.
+     * @param touched Whether each shard changed.
+     */
+    void publish(const std::vector<bool> &touched) {
+        if (!copy_on_write) {
+            return;
+        }
+
+        publishes_begun.fetch_add(1, std::memory_order_acq_rel);
+        for (std::size_t i = 0; i < shards.size(); ++i) {
+            if (touched[i]) {
+                replaceSnapshot(shards[i]);
+            }
+        }
+        publishes_done.fetch_add(1, std::memory_order_release);
+    }
+
+    static void warn(std::string_view message) {
         auto logger = ::PureIOC::getService<::PureIOC::ILogger>();
         if (logger) {
-            logger->warn<DefaultServices>("Service is already registered with contract");
+            logger->warn<DefaultServices>(message);
         }
+    }
 
-        return false;
+    bool registerEntry(const Key &key, ServiceLifetime lifetime, ServiceFactory factory, std::any instance) {
+        return registerEntry(key, makeEntry(key, lifetime, std::move(factory), std::move(instance)));
     }
 
+    bool registerEntry(const Key &key, std::shared_ptr<ServiceEntry> entry) {
+        Shard &shard = shardOf(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        if (frozen.load(std::memory_order_relaxed)) {
+            lock.unlock();
+            warn("Container is frozen, registrations cannot change");
+            return false;
+        }
+
+        if (shard.entries.find(key)) {
+            lock.unlock();
+            warn("Service is already registered with contract");
+            return false;
+        }
+
+        shard.entries[key] = std::move(entry);
+        present.add(key);
+        publish(shard);
+        lock.unlock();
+        changed();
+
+        return true;
+    }
+
+    std::vector<std::pair<Key, std::shared_ptr<ServiceEntry>>> makeBatch(std::vector<ServiceRegistration> &registrations) const;
+    std::size_t registerBatch(std::vector<std::pair<Key, std::shared_ptr<ServiceEntry>>> batch, bool all);
     void unregisterService(const Key &key);
+    void unregisterAll(const std::vector<Key> &keys);
+    void freeze();
 };
 
 DefaultServices::DefaultServices()
-    : _impl(std::make_unique<DefaultServices::Impl>()) {}
+    : DefaultServices(ContainerOptions()) {}
+
+DefaultServices::DefaultServices(const ContainerOptions &options)
+    : _impl(std::make_unique<DefaultServices::Impl>(options)) {}
 
 DefaultServices::~DefaultServices() = default;
 
@@ -115,8 +788,20 @@ DefaultServices::~DefaultServices() = default;
  */
 std::optional<std::any>
 DefaultServices::getService(const std::type_index &type) {
-    Key key(type, std::nullopt);
-    return this->_impl->getService(key);
+    Key key(typeSlot(type), 0);
+    return this->_impl->getService(key, type);
+}
+
+/**
+ * @brief Gets the service by the precomputed slot of its type.
+ * @param slot The slot of the type.
+ * @param type The type of the service.
+ * @return The service.
+ */
+std::optional<std::any>
+DefaultServices::getService(std::size_t slot, const std::type_index &type) {
+    Key key(slot, 0);
+    return this->_impl->getService(key, type);
 }
 
 /**
@@ -127,103 +812,425 @@ DefaultServices::getService(const std::type_index &type) {
  */
 std::optional<std::any>
 DefaultServices::getService(const std::type_index &type, const std::string &contract) {
-    Key key(type, std::optional<std::string>(contract));
-    return this->_impl->getService(key);
+    std::optional<Key> key = findKey(type, contract);
+    if (!key) {
+        return this->_impl->parent ? this->_impl->parent->getService(type, contract) : std::nullopt;
+    }
+
+    return this->_impl->getService(*key, type);
 }
 
 /**
- * @brief Gets the registered constant.
- * @param key The key.
- * @return The registered constant.
+ * @brief Gets the service by the precomputed slot of its type and a contract view.
+ * @param slot The slot of the type.
+ * @param type The type of the service.
+ * @param contract The contract.
+ * @return The service.
  */
 std::optional<std::any>
-DefaultServices::Impl::getRegisteredConstant(const Key &key) const {
-    std::shared_lock<std::shared_mutex> lock(mutex);
-    auto it = services.find(key);
-    if (it != services.end()) {
-        return std::optional<std::any>(it->second);
+DefaultServices::getService(std::size_t slot, const std::type_index &type, std::string_view contract) {
+    std::optional<ContractId> id = findContract(contract);
+    if (!id) {
+        return this->_impl->parent ? this->_impl->parent->getService(slot, type, contract) : std::nullopt;
     }
 
-    return std::nullopt;
+    return this->_impl->getService(Key(slot, id->value()), type);
 }
 
 /**
- * @brief Gets the registered factory.
- * @param map The map.
- * @param key The key.
- * @return The registered factory.
+ * @brief Gets the service by the precomputed slot of its type and an interned contract.
+ * @param slot The slot of the type.
+ * @param type The type of the service.
+ * @param contract The interned contract.
+ * @return The service.
  */
 std::optional<std::any>
-DefaultServices::Impl::getRegisteredFactory(const Map<std::function<std::any()>> &map, const Key &key) const {
-    std::optional<std::function<std::any()>> factory = std::nullopt;
+DefaultServices::getService(std::size_t slot, const std::type_index &type, ContractId contract) {
+    Key key(slot, contract.value());
+    return this->_impl->getService(key, type);
+}
+
+/**
+ * @brief Gets the generation of the registrations visible through the container.
+ *
+ * The versions of the container and of its ancestors only grow, so their sum
+ * changes whenever any of them does.
+ * @return The number of changes to this container and its ancestors.
+ */
+std::uint64_t
+DefaultServices::generation() noexcept {
+    const std::uint64_t own = this->_impl->version.load(std::memory_order_acquire);
+    return this->_impl->parent ? own + this->_impl->parent->generation() : own;
+}
+
+/**
+ * @brief Gets the lifetime of the service.
+ * @param type The type of the service.
+ * @return The lifetime, or std::nullopt if the service is not registered.
+ */
+std::optional<ServiceLifetime>
+DefaultServices::getLifetime(const std::type_index &type) {
+    Key key(typeSlot(type), 0);
+    return this->_impl->getLifetime(key, type);
+}
+
+/**
+ * @brief Gets the lifetime of the service.
+ * @param type The type of the service.
+ * @param contract The contract.
+ * @return The lifetime, or std::nullopt if the service is not registered.
+ */
+std::optional<ServiceLifetime>
+DefaultServices::getLifetime(const std::type_index &type, const std::string &contract) {
+    std::optional<Key> key = findKey(type, contract);
+    if (!key) {
+        return this->_impl->parent ? this->_impl->parent->getLifetime(type, contract) : std::nullopt;
+    }
+
+    return this->_impl->getLifetime(*key, type);
+}
+
+/**
+ * @brief Gets the lifetime of the service.
+ * @param key The key.
+ * @param type The type of the service.
+ * @return The lifetime, or std::nullopt if the service is not registered.
+ */
+std::optional<ServiceLifetime>
+DefaultServices::Impl::getLifetime(const Key &key, const std::type_index &type) const {
+    if (std::shared_ptr<ServiceEntry> entry = findOwnEntry(key)) {
+        return entry->lifetime();
+    }
+
+    if (!parent) {
+        return std::nullopt;
+    }
+
+    if (std::optional<std::shared_ptr<ServiceEntry>> inherited = findInheritedEntry(key, type)) {
+        return *inherited ? std::optional<ServiceLifetime>((*inherited)->lifetime()) : std::nullopt;
+    }
+
+    return key.second ? parent->getLifetime(type, contractName(ContractId(key.second))) : parent->getLifetime(type);
+}
+
+/**
+ * @brief Finds the entry of the service, falling back to the parent.
+ * @param key The key.
+ * @param type The type of the service.
+ * @return The entry, or nullptr if neither this container nor its parent exposes one.
+ */
+std::shared_ptr<ServiceEntry>
+DefaultServices::Impl::findEntry(const Key &key, const std::type_index &type) const {
+    std::shared_ptr<ServiceEntry> entry = findOwnEntry(key);
+    return entry || !parent ? entry : findInheritedEntry(key, type).value_or(nullptr);
+}
+
+/**
+ * @brief Finds the entry of a service registered in this container.
+ * @param key The key.
+ * @return The entry, or nullptr if the service is not registered.
+ */
+std::shared_ptr<ServiceEntry>
+DefaultServices::Impl::findOwnEntry(const Key &key) const {
+    if (const FrozenTable *table = frozen.load(std::memory_order_acquire)) {
+        const std::shared_ptr<ServiceEntry> *entry = table->find(key);
+        return entry ? *entry : nullptr;
+    }
+
+    if (!present.mayContain(key)) {
+        return nullptr;
+    }
+
+    const Shard &shard = shardOf(key);
+    if (copy_on_write) {
+        EpochGuard guard;
+        const std::shared_ptr<ServiceEntry> *entry = shard.snapshot.load(std::memory_order_acquire)->find(key);
+        return entry ? *entry : nullptr;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    const std::shared_ptr<ServiceEntry> *entry = shard.entries.find(key);
+    return entry ? *entry : nullptr;
+}
+
+/**
+ * @brief Finds the entry of a service through the parent, caching it.
+ *
+ * A parent that reports a generation is asked once per generation of its
+ * own, and its answer is cached whether it exposes an entry or not; entries
+ * it resolved through its own ancestors are cached here as well, so the
+ * hierarchy is flattened. A parent that reports no generation is asked
+ * every time.
+ * @param key The key.
+ * @param type The type of the service.
+ * @return The entry, nullptr if the parent does not expose the service, or std::nullopt if the parent exposes no entry but may still resolve the service.
+ */
+std::optional<std::shared_ptr<ServiceEntry>>
+DefaultServices::Impl::findInheritedEntry(const Key &key, const std::type_index &type) const {
+    const std::uint64_t generation = parent->generation();
+    if (!generation) {
+        std::shared_ptr<ServiceEntry> entry = parent->getEntry(key.first, type, ContractId(key.second));
+        return entry ? std::optional<std::shared_ptr<ServiceEntry>>(std::move(entry)) : std::nullopt;
+    }
+
     {
-        std::shared_lock<std::shared_mutex> lock(mutex);
-        auto it = map.find(key);
-        if (it != map.end()) {
-            factory = std::optional<std::function<std::any()>>(it->second);
+        EpochGuard guard;
+        const InheritedTable *table = inherited.table.load(std::memory_order_acquire);
+        if (table && table->generation() == generation) {
+            if (const std::shared_ptr<ServiceEntry> *entry = table->find(key)) {
+                return *entry;
+            }
         }
     }
 
-    return factory ? std::optional<std::any>(factory.value()()) : std::nullopt;
+    std::shared_ptr<ServiceEntry> entry = parent->getEntry(key.first, type, ContractId(key.second));
+    cacheInherited(key, entry, generation);
+
+    return entry;
 }
 
 /**
  * @brief Gets the service.
+ *
+ * The entry is found with a single probe under a single shared lock; the
+ * service itself is resolved after the lock is released. Services missing
+ * here resolve through the parent.
  * @param key The key.
+ * @param type The type of the service.
  * @return The service.
  */
 std::optional<std::any>
-DefaultServices::Impl::getService(const Key &key) {
-    auto service = getRegisteredConstant(key);
-    if (service) {
-        return service;
+DefaultServices::Impl::getService(const Key &key, const std::type_index &type) const {
+    recordResolution(key);
+    if (const FrozenTable *table = frozen.load(std::memory_order_acquire)) {
+        if (const std::shared_ptr<ServiceEntry> *entry = table->find(key)) {
+            return resolve(**entry);
+        }
+    } else if (std::shared_ptr<ServiceEntry> entry = findOwnEntry(key)) {
+        return resolve(*entry);
     }
 
-    service = getLazySingleton(key);
-    if (service) {
-        return service;
+    if (!parent) {
+        return std::nullopt;
     }
 
-    return getRegisteredFactory(factories, key);
+    if (std::optional<std::shared_ptr<ServiceEntry>> inherited = findInheritedEntry(key, type)) {
+        return *inherited ? resolve(**inherited) : std::nullopt;
+    }
+
+    return parent->getService(key.first, type, ContractId(key.second));
 }
 
 /**
- * @brief Gets the lazy singleton.
- * @param key The key.
- * @return The service.
+ * @brief Gets several services.
+ * @param requests The services to get.
+ * @param results Receives an optional containing each service if found.
+ * @param count The number of requests.
  */
-std::optional<std::any>
-DefaultServices::Impl::getLazySingleton(const Key &key) {
-    std::function<std::any()> factory;
-    std::shared_ptr<std::once_flag> once_flag;
-    {
-        std::shared_lock<std::shared_mutex> lock(mutex);
-        auto it = singleton_factories.find(key);
-        if (it == singleton_factories.end()) {
-            return std::nullopt;
+void
+DefaultServices::getServices(const ServiceRequest *requests, std::optional<std::any> *results, std::size_t count) {
+    this->_impl->getServices(requests, results, count);
+}
+
+/**
+ * @brief Gets several services.
+ *
+ * All entries are found first, from one consistent view of the
+ * registrations, so a concurrent registration or unregistration is seen
+ * either by every request or by none. The services are resolved after that
+ * view is released. Services missing here resolve through the parent one by
+ * one.
+ * @param requests The services to get.
+ * @param results Receives an optional containing each service if found.
+ * @param count The number of requests.
+ */
+void
+DefaultServices::Impl::getServices(const ServiceRequest *requests, std::optional<std::any> *results, std::size_t count) const {
+    constexpr std::size_t InlineCount = 16;
+    std::array<std::shared_ptr<ServiceEntry>, InlineCount> inline_entries;
+    std::vector<std::shared_ptr<ServiceEntry>> heap_entries;
+    std::shared_ptr<ServiceEntry> *entries = inline_entries.data();
+    if (count > InlineCount) {
+        heap_entries.resize(count);
+        entries = heap_entries.data();
+    }
+
+    findOwnEntries(requests, entries, count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const ServiceRequest &request = requests[i];
+        const Key key(request.slot, request.contract.value());
+        recordResolution(key);
+        if (!entries[i] && parent) {
+            std::optional<std::shared_ptr<ServiceEntry>> inherited = findInheritedEntry(key, request.type);
+            if (!inherited) {
+                results[i] = parent->getService(request.slot, request.type, request.contract);
+                continue;
+            }
+            entries[i] = std::move(*inherited);
         }
-        factory = it->second;
 
-        auto flag_it = singleton_once_flags.find(key);
-        if (flag_it != singleton_once_flags.end()) {
-            once_flag = flag_it->second;
+        results[i] = entries[i] ? resolve(*entries[i]) : std::nullopt;
+    }
+}
+
+/**
+ * @brief Finds the entries of several services registered in this container.
+ *
+ * A frozen table is read as is. In copy-on-write mode the snapshots of the
+ * shards are read without locking, again if a publication raced with the
+ * lookup. Otherwise the shared locks of the shards the requests fall in are
+ * taken together, in shard order, for the whole lookup.
+ * @param requests The services to find.
+ * @param entries Receives the entry of each service, or nullptr if it is not registered.
+ * @param count The number of requests.
+ */
+void
+DefaultServices::Impl::findOwnEntries(const ServiceRequest *requests, std::shared_ptr<ServiceEntry> *entries, std::size_t count) const {
+    if (const FrozenTable *table = frozen.load(std::memory_order_acquire)) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::shared_ptr<ServiceEntry> *entry = table->find(Key(requests[i].slot, requests[i].contract.value()));
+            entries[i] = entry ? *entry : nullptr;
         }
+        return;
     }
 
-    if (!once_flag) {
-        std::unique_lock<std::shared_mutex> lock(mutex);
-        auto &flag_slot = singleton_once_flags[key];
-        if (!flag_slot) {
-            flag_slot = std::make_shared<std::once_flag>();
+    if (copy_on_write) {
+        EpochGuard guard;
+        for (;;) {
+            const std::uint64_t begun = publishes_begun.load(std::memory_order_acquire);
+            if (publishes_done.load(std::memory_order_acquire) != begun) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const Key key(requests[i].slot, requests[i].contract.value());
+                const std::shared_ptr<ServiceEntry> *entry = present.mayContain(key)
+                    ? shardOf(key).snapshot.load(std::memory_order_acquire)->find(key)
+                    : nullptr;
+                entries[i] = entry ? *entry : nullptr;
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (publishes_begun.load(std::memory_order_relaxed) == begun) {
+                return;
+            }
         }
-        once_flag = flag_slot;
     }
 
-    std::call_once(*once_flag, [&] {
-        registerService<std::any>(services, key, factory());
-    });
+    auto touched = [&](const Shard &shard) {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (&shardOf(Key(requests[i].slot, requests[i].contract.value())) == &shard) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    for (const Shard &shard : shards) {
+        if (touched(shard)) {
+            shard.mutex.lock_shared();
+        }
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const Key key(requests[i].slot, requests[i].contract.value());
+        const std::shared_ptr<ServiceEntry> *entry = present.mayContain(key) ? shardOf(key).entries.find(key) : nullptr;
+        entries[i] = entry ? *entry : nullptr;
+    }
 
-    return getRegisteredConstant(key);
+    for (const Shard &shard : shards) {
+        if (touched(shard)) {
+            shard.mutex.unlock_shared();
+        }
+    }
+}
+
+/**
+ * @brief Borrows the shared instance of the service.
+ * @param slot The slot of the type.
+ * @param type The type of the service.
+ * @param contract The interned contract.
+ * @return The instance, or nullptr if the service is not registered or is transient.
+ */
+const std::any *
+DefaultServices::borrowService(std::size_t slot, const std::type_index &type, ContractId contract) {
+    Key key(slot, contract.value());
+    return this->_impl->borrowService(key, type);
+}
+
+/**
+ * @brief Borrows the shared instance of the service.
+ *
+ * An instance that is already published is returned without copying the
+ * entry pointer, so no reference count is touched, unless the service may
+ * have to be borrowed from the parent.
+ * @param key The key.
+ * @param type The type of the service.
+ * @return The instance, or nullptr if the service is not registered or is transient.
+ */
+const std::any *
+DefaultServices::Impl::borrowService(const Key &key, const std::type_index &type) const {
+    recordResolution(key);
+    if (parent) {
+        if (std::shared_ptr<ServiceEntry> entry = findOwnEntry(key)) {
+            return entry->borrow();
+        }
+        if (std::optional<std::shared_ptr<ServiceEntry>> inherited = findInheritedEntry(key, type)) {
+            return *inherited ? (*inherited)->borrow() : nullptr;
+        }
+        return parent->borrowService(key.first, type, ContractId(key.second));
+    }
+
+    if (const FrozenTable *table = frozen.load(std::memory_order_acquire)) {
+        const std::shared_ptr<ServiceEntry> *entry = table->find(key);
+        return entry ? (*entry)->borrow() : nullptr;
+    }
+
+    if (!present.mayContain(key)) {
+        return nullptr;
+    }
+
+    const Shard &shard = shardOf(key);
+    std::shared_ptr<ServiceEntry> entry;
+    if (copy_on_write) {
+        EpochGuard guard;
+        const std::shared_ptr<ServiceEntry> *found = shard.snapshot.load(std::memory_order_acquire)->find(key);
+        if (!found) {
+            return nullptr;
+        }
+        if (const std::any *ready = (*found)->peek()) {
+            return ready;
+        }
+        entry = *found;
+    } else {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        const std::shared_ptr<ServiceEntry> *found = shard.entries.find(key);
+        if (!found) {
+            return nullptr;
+        }
+        if (const std::any *ready = (*found)->peek()) {
+            return ready;
+        }
+        entry = *found;
+    }
+
+    return entry->borrow();
+}
+
+/**
+ * @brief Gets the registration entry of the service.
+ * @param slot The slot of the type.
+ * @param type The type of the service.
+ * @param contract The interned contract.
+ * @return The entry, or nullptr if the service is not registered.
+ */
+std::shared_ptr<ServiceEntry>
+DefaultServices::getEntry(std::size_t slot, const std::type_index &type, ContractId contract) {
+    Key key(slot, contract.value());
+    this->_impl->recordResolution(key);
+    return this->_impl->findEntry(key, type);
 }
 
 /**
@@ -234,9 +1241,8 @@ DefaultServices::Impl::getLazySingleton(const Key &key) {
  */
 bool
 DefaultServices::registerService(const std::type_index &type, std::function<std::any()> factory) {
-    Key key(type, std::nullopt);
-    return this->_impl->registerService<std::function<std::any()>>(
-        this->_impl->factories, key, std::move(factory));
+    Key key(typeSlot(type), 0);
+    return this->_impl->registerEntry(key, ServiceLifetime::Transient, std::move(factory), std::any());
 }
 
 /**
@@ -248,9 +1254,8 @@ DefaultServices::registerService(const std::type_index &type, std::function<std:
  */
 bool
 DefaultServices::registerService(const std::type_index &type, const std::string &contract, std::function<std::any()> factory) {
-    Key key(type, std::optional<std::string>(contract));
-    return this->_impl->registerService<std::function<std::any()>>(
-        this->_impl->factories, key, std::move(factory));
+    Key key = internKey(type, contract);
+    return this->_impl->registerEntry(key, ServiceLifetime::Transient, std::move(factory), std::any());
 }
 
 /**
@@ -261,8 +1266,8 @@ DefaultServices::registerService(const std::type_index &type, const std::string
  */
 bool
 DefaultServices::registerLazySingleton(const std::type_index &type, std::function<std::any()> factory) {
-    Key key(type, std::nullopt);
-    return this->_impl->registerLazySingleton(key, std::move(factory));
+    Key key(typeSlot(type), 0);
+    return this->_impl->registerEntry(key, ServiceLifetime::LazySingleton, std::move(factory), std::any());
 }
 
 /**
@@ -274,8 +1279,8 @@ DefaultServices::registerLazySingleton(const std::type_index &type, std::functio
  */
 bool
 DefaultServices::registerLazySingleton(const std::type_index &type, const std::string &contract, std::function<std::any()> factory) {
-    Key key(type, std::optional<std::string>(contract));
-    return this->_impl->registerLazySingleton(key, std::move(factory));
+    Key key = internKey(type, contract);
+    return this->_impl->registerEntry(key, ServiceLifetime::LazySingleton, std::move(factory), std::any());
 }
 
 /**
@@ -286,8 +1291,8 @@ DefaultServices::registerLazySingleton(const std::type_index &type, const std::s
  */
 bool
 DefaultServices::registerConstant(const std::type_index &type, std::any service) {
-    Key key(type, std::nullopt);
-    return this->_impl->registerService<std::any>(this->_impl->services, key, std::move(service));
+    Key key(typeSlot(type), 0);
+    return this->_impl->registerEntry(key, ServiceLifetime::Constant, nullptr, std::move(service));
 }
 
 /**
@@ -299,8 +1304,255 @@ DefaultServices::registerConstant(const std::type_index &type, std::any service)
  */
 bool
 DefaultServices::registerConstant(const std::type_index &type, const std::string &contract, std::any service) {
-    Key key(type, std::optional<std::string>(contract));
-    return this->_impl->registerService<std::any>(this->_impl->services, key, std::move(service));
+    Key key = internKey(type, contract);
+    return this->_impl->registerEntry(key, ServiceLifetime::Constant, nullptr, std::move(service));
+}
+
+/**
+ * @brief Registers the scoped service.
+ * @param type The type of the service.
+ * @param factory The factory.
+ * @return True if the scoped service was registered, false otherwise.
+ */
+bool
+DefaultServices::registerScoped(const std::type_index &type, std::function<std::shared_ptr<void>(Scope &)> factory) {
+    Key key(typeSlot(type), 0);
+    return this->_impl->registerEntry(key, this->_impl->makeEntry(key, std::move(factory)));
+}
+
+/**
+ * @brief Registers the scoped service.
+ * @param type The type of the service.
+ * @param contract The contract.
+ * @param factory The factory.
+ * @return True if the scoped service was registered, false otherwise.
+ */
+bool
+DefaultServices::registerScoped(const std::type_index &type, const std::string &contract, std::function<std::shared_ptr<void>(Scope &)> factory) {
+    Key key = internKey(type, contract);
+    return this->_impl->registerEntry(key, this->_impl->makeEntry(key, std::move(factory)));
+}
+
+/**
+ * @brief Registers the pooled service.
+ * @param type The type of the service.
+ * @param factory The factory.
+ * @return True if the pooled service was registered, false otherwise.
+ */
+bool
+DefaultServices::registerPooled(const std::type_index &type, std::function<std::any()> factory) {
+    Key key(typeSlot(type), 0);
+    return this->_impl->registerEntry(key, ServiceLifetime::Pooled, std::move(factory), std::any());
+}
+
+/**
+ * @brief Registers the pooled service.
+ * @param type The type of the service.
+ * @param contract The contract.
+ * @param factory The factory.
+ * @return True if the pooled service was registered, false otherwise.
+ */
+bool
+DefaultServices::registerPooled(const std::type_index &type, const std::string &contract, std::function<std::any()> factory) {
+    Key key = internKey(type, contract);
+    return this->_impl->registerEntry(key, ServiceLifetime::Pooled, std::move(factory), std::any());
+}
+
+/**
+ * @brief Registers the factory of a transient, lazy singleton or pooled service.
+ * @param type The type of the service.
+ * @param lifetime The lifetime of the service.
+ * @param factory The factory.
+ * @return True if the service was registered, false otherwise.
+ */
+bool
+DefaultServices::registerFactory(const std::type_index &type, ServiceLifetime lifetime, ServiceFactory factory) {
+    if (lifetime != ServiceLifetime::Transient && lifetime != ServiceLifetime::LazySingleton && lifetime != ServiceLifetime::Pooled) {
+        return false;
+    }
+
+    Key key(typeSlot(type), 0);
+    return this->_impl->registerEntry(key, lifetime, std::move(factory), std::any());
+}
+
+/**
+ * @brief Registers the factory of a transient, lazy singleton or pooled service.
+ * @param type The type of the service.
+ * @param contract The contract.
+ * @param lifetime The lifetime of the service.
+ * @param factory The factory.
+ * @return True if the service was registered, false otherwise.
+ */
+bool
+DefaultServices::registerFactory(const std::type_index &type, const std::string &contract, ServiceLifetime lifetime, ServiceFactory factory) {
+    if (lifetime != ServiceLifetime::Transient && lifetime != ServiceLifetime::LazySingleton && lifetime != ServiceLifetime::Pooled) {
+        return false;
+    }
+
+    Key key = internKey(type, contract);
+    return this->_impl->registerEntry(key, lifetime, std::move(factory), std::any());
+}
+
+/**
+ * @brief Lists the registration entries.
+ * @return The entries, not including those inherited from the parent.
+ */
+std::vector<RegisteredEntry>
+DefaultServices::getEntries() {
+    std::vector<RegisteredEntry> entries;
+    auto add = [&](const Key &key, const std::shared_ptr<ServiceEntry> &entry) {
+        entries.push_back(RegisteredEntry{key.first, ContractId(key.second), entry});
+    };
+    for (const Shard &shard : this->_impl->shards) {
+        if (this->_impl->copy_on_write) {
+            EpochGuard guard;
+            shard.snapshot.load(std::memory_order_acquire)->forEach(add);
+            continue;
+        }
+
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        shard.entries.forEach(add);
+    }
+
+    return entries;
+}
+
+/**
+ * @brief Registers a batch of services.
+ * @param registrations The registrations.
+ * @return The number of services registered.
+ */
+std::size_t
+DefaultServices::registerBatch(std::vector<ServiceRegistration> registrations) {
+    return this->_impl->registerBatch(this->_impl->makeBatch(registrations), false);
+}
+
+/**
+ * @brief Registers a batch of services, all of them or none.
+ * @param registrations The registrations.
+ * @return True if every service was registered, false if none was.
+ */
+bool
+DefaultServices::registerAll(std::vector<ServiceRegistration> registrations) {
+    const std::size_t count = registrations.size();
+    return this->_impl->registerBatch(this->_impl->makeBatch(registrations), true) == count;
+}
+
+/**
+ * @brief Builds the keys and entries of a batch of registrations.
+ * @param registrations The registrations; their factories and instances are moved from.
+ * @return The keys and entries.
+ */
+std::vector<std::pair<Key, std::shared_ptr<ServiceEntry>>>
+DefaultServices::Impl::makeBatch(std::vector<ServiceRegistration> &registrations) const {
+    std::vector<std::pair<Key, std::shared_ptr<ServiceEntry>>> batch;
+    batch.reserve(registrations.size());
+    for (ServiceRegistration &registration : registrations) {
+        Key key = registration.contract ? internKey(registration.type, *registration.contract) : Key(typeSlot(registration.type), 0);
+        std::shared_ptr<ServiceEntry> entry = registration.lifetime == ServiceLifetime::Scoped
+            ? makeEntry(key, std::move(registration.scopedFactory))
+            : makeEntry(key, registration.lifetime, std::move(registration.factory), std::move(registration.instance));
+        batch.emplace_back(key, std::move(entry));
+    }
+
+    return batch;
+}
+
+/**
+ * @brief Registers a batch of entries.
+ *
+ * Entries are built before any lock is taken. Every shard is then locked
+ * once, its tables are grown once for the whole batch, and the batch is
+ * inserted, published and announced with a single generation change.
+ * @param batch The keys and entries.
+ * @param all Whether to reject the whole batch if any of its keys is already registered or repeated.
+ * @return The number of entries registered.
+ */
+std::size_t
+DefaultServices::Impl::registerBatch(std::vector<std::pair<Key, std::shared_ptr<ServiceEntry>>> batch, bool all) {
+    if (all) {
+        std::vector<Key> keys;
+        keys.reserve(batch.size());
+        for (const auto &[key, entry] : batch) {
+            keys.push_back(key);
+        }
+        std::sort(keys.begin(), keys.end());
+        if (std::adjacent_find(keys.begin(), keys.end()) != keys.end()) {
+            warn("Services appear twice in the batch, none were registered");
+            return 0;
+        }
+    }
+
+    std::vector<std::size_t> slots(shards.size(), 0);
+    std::vector<std::size_t> contracted(shards.size(), 0);
+    std::vector<std::size_t> indices;
+    indices.reserve(batch.size());
+    for (const auto &[key, entry] : batch) {
+        const std::size_t index = &shardOf(key) - shards.data();
+        indices.push_back(index);
+        if (key.second) {
+            ++contracted[index];
+        } else {
+            slots[index] = std::max(slots[index], key.first + 1);
+        }
+    }
+
+    std::size_t registered = 0;
+    std::size_t duplicates = 0;
+    {
+        std::vector<std::unique_lock<std::shared_mutex>> locks;
+        locks.reserve(shards.size());
+        for (Shard &shard : shards) {
+            locks.emplace_back(shard.mutex);
+        }
+
+        if (frozen.load(std::memory_order_relaxed)) {
+            locks.clear();
+            warn("Container is frozen, registrations cannot change");
+            return 0;
+        }
+
+        if (all) {
+            for (std::size_t i = 0; i < batch.size(); ++i) {
+                if (shards[indices[i]].entries.find(batch[i].first)) {
+                    locks.clear();
+                    warn("Services in the batch are already registered with their contract, none were registered");
+                    return 0;
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < shards.size(); ++i) {
+            shards[i].entries.reserve(slots[i], contracted[i]);
+        }
+
+        std::vector<bool> touched(shards.size(), false);
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            auto &[key, entry] = batch[i];
+            Shard &shard = shards[indices[i]];
+            if (shard.entries.find(key)) {
+                ++duplicates;
+                continue;
+            }
+
+            shard.entries[key] = std::move(entry);
+            present.add(key);
+            touched[indices[i]] = true;
+            ++registered;
+        }
+
+        publish(touched);
+    }
+
+    if (registered) {
+        changed();
+    }
+
+    if (duplicates) {
+        warn(std::to_string(duplicates) + " services in the batch are already registered with their contract");
+    }
+
+    return registered;
 }
 
 /**
@@ -309,7 +1561,7 @@ DefaultServices::registerConstant(const std::type_index &type, const std::string
  */
 void
 DefaultServices::unregisterService(const std::type_index &type) {
-    Key key(type, std::nullopt);
+    Key key(typeSlot(type), 0);
     this->_impl->unregisterService(key);
 }
 
@@ -320,8 +1572,10 @@ DefaultServices::unregisterService(const std::type_index &type) {
  */
 void
 DefaultServices::unregisterService(const std::type_index &type, const std::string &contract) {
-    Key key(type, std::optional<std::string>(contract));
-    this->_impl->unregisterService(key);
+    std::optional<Key> key = findKey(type, contract);
+    if (key) {
+        this->_impl->unregisterService(*key);
+    }
 }
 
 /**
@@ -330,11 +1584,120 @@ DefaultServices::unregisterService(const std::type_index &type, const std::strin
  */
 void
 DefaultServices::Impl::unregisterService(const Key &key) {
-    std::unique_lock<std::shared_mutex> lock(mutex);
+    Shard &shard = shardOf(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    if (frozen.load(std::memory_order_relaxed)) {
+        lock.unlock();
+        warn("Container is frozen, registrations cannot change");
+        return;
+    }
+
+    if (!shard.entries.find(key)) {
+        return;
+    }
+
+    shard.entries.erase(key);
+    present.remove(key);
+    publish(shard);
+    lock.unlock();
+    changed();
+}
+
+/**
+ * @brief Unregisters several services at once.
+ * @param services The services.
+ */
+void
+DefaultServices::unregisterAll(const std::vector<ServiceKey> &services) {
+    std::vector<Key> keys;
+    keys.reserve(services.size());
+    for (const ServiceKey &service : services) {
+        if (!service.contract) {
+            keys.emplace_back(typeSlot(service.type), 0);
+        } else if (std::optional<Key> key = findKey(service.type, *service.contract)) {
+            keys.push_back(*key);
+        }
+    }
+
+    this->_impl->unregisterAll(keys);
+}
+
+/**
+ * @brief Unregisters several services.
+ *
+ * Every shard is locked once, so readers see either all of the services or
+ * none of them, and the removal is announced with a single generation change.
+ * @param keys The keys.
+ */
+void
+DefaultServices::Impl::unregisterAll(const std::vector<Key> &keys) {
+    bool removed = false;
+    {
+        std::vector<std::unique_lock<std::shared_mutex>> locks;
+        locks.reserve(shards.size());
+        for (Shard &shard : shards) {
+            locks.emplace_back(shard.mutex);
+        }
 
-    services.erase(key);
-    singleton_factories.erase(key);
-    singleton_once_flags.erase(key);
-    factories.erase(key);
+        if (frozen.load(std::memory_order_relaxed)) {
+            locks.clear();
+            warn("Container is frozen, registrations cannot change");
+            return;
+        }
+
+        std::vector<bool> touched(shards.size(), false);
+        for (const Key &key : keys) {
+            Shard &shard = shardOf(key);
+            if (!shard.entries.find(key)) {
+                continue;
+            }
+
+            shard.entries.erase(key);
+            present.remove(key);
+            touched[&shard - shards.data()] = true;
+            removed = true;
+        }
+
+        publish(touched);
+    }
+
+    if (removed) {
+        changed();
+    }
+}
+
+/**
+ * @brief Freezes the registrations.
+ * @return True, the default container always supports freezing.
+ */
+bool
+DefaultServices::freeze() {
+    this->_impl->freeze();
+    return true;
+}
+
+/**
+ * @brief Compiles the registrations into a frozen table and publishes it.
+ *
+ * Every shard stays locked until the table is published, so a registration
+ * either makes it into the table or sees the container frozen.
+ */
+void
+DefaultServices::Impl::freeze() {
+    std::vector<std::unique_lock<std::shared_mutex>> locks;
+    locks.reserve(shards.size());
+    for (Shard &shard : shards) {
+        locks.emplace_back(shard.mutex);
+    }
+    if (frozen.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    std::pmr::vector<FrozenEntry> compiled(resource);
+    for (const Shard &shard : shards) {
+        compile(shard, compiled);
+    }
+    frozen_table = makeTable(std::move(compiled));
+    frozen.store(frozen_table.get(), std::memory_order_release);
 }
 }
@@ -9,12 +9,16 @@
 #include <string>
 #include <functional>
 #include <any>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <typeindex>
 
+#include "container-options.h"
+#include "contract-id.h"
 #include "services-interface.h"
 
 namespace PureIOC::internal {
@@ -34,6 +38,11 @@ public:
      * @brief Default constructor.
      */
     DefaultServices();
+    /**
+     * @brief Constructs a container with the given options.
+     * @param options The options of the container.
+     */
+    explicit DefaultServices(const ContainerOptions &options);
     /**
      * @brief Default destructor.
      */
@@ -57,6 +66,81 @@ public:
      * @return An optional containing the service if found.
      */
     std::optional<std::any> getService(const std::type_index &type, const std::string &contract) override;
+    /**
+     * @brief Gets a service of the specified type using its precomputed slot.
+     * @param slot The slot of the type, as returned by typeSlot().
+     * @param type The type of the service to get.
+     * @return An optional containing the service if found.
+     */
+    std::optional<std::any> getService(std::size_t slot, const std::type_index &type) override;
+    /**
+     * @brief Gets a service using the precomputed slot of its type and a contract view.
+     * @param slot The slot of the type, as returned by typeSlot().
+     * @param type The type of the service to get.
+     * @param contract The contract for the service.
+     * @return An optional containing the service if found.
+     */
+    std::optional<std::any> getService(std::size_t slot, const std::type_index &type, std::string_view contract) override;
+    /**
+     * @brief Gets a service using the precomputed slot of its type and an interned contract.
+     * @param slot The slot of the type, as returned by typeSlot().
+     * @param type The type of the service to get.
+     * @param contract The interned contract for the service.
+     * @return An optional containing the service if found.
+     */
+    std::optional<std::any> getService(std::size_t slot, const std::type_index &type, ContractId contract) override;
+
+    /**
+     * @brief Gets several services from one consistent view of the registrations.
+     * @param requests The services to get.
+     * @param results Receives an optional containing each service if found.
+     * @param count The number of requests.
+     */
+    void getServices(const ServiceRequest *requests, std::optional<std::any> *results, std::size_t count) override;
+
+    /**
+     * @brief Gets the generation of the registrations visible through the container.
+     * @return The number of changes to this container and its ancestors.
+     */
+    std::uint64_t generation() noexcept override;
+
+    /**
+     * @brief Gets the lifetime a service was registered with.
+     * @param type The type of the service.
+     * @return The lifetime of the service, or std::nullopt if not registered.
+     */
+    std::optional<ServiceLifetime> getLifetime(const std::type_index &type) override;
+    /**
+     * @brief Gets the lifetime a service with a contract was registered with.
+     * @param type The type of the service.
+     * @param contract The contract for the service.
+     * @return The lifetime of the service, or std::nullopt if not registered.
+     */
+    std::optional<ServiceLifetime> getLifetime(const std::type_index &type, const std::string &contract) override;
+
+    /**
+     * @brief Borrows the shared instance of a constant or lazy singleton.
+     * @param slot The slot of the type, as returned by typeSlot().
+     * @param type The type of the service.
+     * @param contract The interned contract for the service.
+     * @return The instance, or nullptr if the service is not registered or is transient.
+     */
+    const std::any *borrowService(std::size_t slot, const std::type_index &type, ContractId contract) override;
+
+    /**
+     * @brief Gets the registration entry of a service.
+     * @param slot The slot of the type, as returned by typeSlot().
+     * @param type The type of the service.
+     * @param contract The interned contract for the service.
+     * @return The entry, or nullptr if the service is not registered.
+     */
+    std::shared_ptr<ServiceEntry> getEntry(std::size_t slot, const std::type_index &type, ContractId contract) override;
+
+    /**
+     * @brief Lists the registration entries of the container.
+     * @return The entries, not including those inherited from the parent.
+     */
+    std::vector<RegisteredEntry> getEntries() override;
 
     /**
      * @brief Registers a factory for a service.
@@ -104,6 +188,76 @@ public:
      */
     bool registerConstant(const std::type_index &type, const std::string &contract, std::any service) override;
 
+    /**
+     * @brief Registers a scoped factory for a service.
+     * @param type The type of the service.
+     * @param factory The factory function, called with the scope that resolves the service.
+     * @return True if the service was registered, false otherwise.
+     */
+    bool registerScoped(const std::type_index &type, std::function<std::shared_ptr<void>(Scope &)> factory) override;
+    /**
+     * @brief Registers a scoped factory for a service with a contract.
+     * @param type The type of the service.
+     * @param contract The contract for the service.
+     * @param factory The factory function, called with the scope that resolves the service.
+     * @return True if the service was registered, false otherwise.
+     */
+    bool registerScoped(const std::type_index &type, const std::string &contract, std::function<std::shared_ptr<void>(Scope &)> factory) override;
+
+    /**
+     * @brief Registers a pooled service.
+     * @param type The type of the service.
+     * @param factory The factory function that acquires an instance from the pool.
+     * @return True if the service was registered, false otherwise.
+     */
+    bool registerPooled(const std::type_index &type, std::function<std::any()> factory) override;
+    /**
+     * @brief Registers a pooled service with a contract.
+     * @param type The type of the service.
+     * @param contract The contract for the service.
+     * @param factory The factory function that acquires an instance from the pool.
+     * @return True if the service was registered, false otherwise.
+     */
+    bool registerPooled(const std::type_index &type, const std::string &contract, std::function<std::any()> factory) override;
+
+    /**
+     * @brief Registers the factory of a transient, lazy singleton or pooled service without copying it.
+     * @param type The type of the service.
+     * @param lifetime The lifetime of the service.
+     * @param factory The factory.
+     * @return True if the service was registered, false otherwise.
+     */
+    bool registerFactory(const std::type_index &type, ServiceLifetime lifetime, ServiceFactory factory) override;
+    /**
+     * @brief Registers the factory of a transient, lazy singleton or pooled service with a contract.
+     * @param type The type of the service.
+     * @param contract The contract for the service.
+     * @param lifetime The lifetime of the service.
+     * @param factory The factory.
+     * @return True if the service was registered, false otherwise.
+     */
+    bool registerFactory(const std::type_index &type, const std::string &contract, ServiceLifetime lifetime, ServiceFactory factory) override;
+
+    /**
+     * @brief Registers a batch of services under a single acquisition of the shard locks.
+     *
+     * Services that are already registered are skipped and reported in a
+     * single warning.
+     * @param registrations The registrations.
+     * @return The number of services registered.
+     */
+    std::size_t registerBatch(std::vector<ServiceRegistration> registrations) override;
+
+    /**
+     * @brief Registers a batch of services, all of them or none, under a single acquisition of the shard locks.
+     *
+     * The batch is rejected as a whole if any of its services is already
+     * registered, or appears in it twice.
+     * @param registrations The registrations.
+     * @return True if every service was registered, false if none was.
+     */
+    bool registerAll(std::vector<ServiceRegistration> registrations) override;
+
     /**
      * @brief Unregisters a service.
      * @param type The type of the service.
@@ -115,6 +269,21 @@ public:
      * @param contract The contract for the service.
      */
     void unregisterService(const std::type_index &type, const std::string &contract) override;
+
+    /**
+     * @brief Unregisters several services under a single acquisition of the shard locks.
+     * @param services The services.
+     */
+    void unregisterAll(const std::vector<ServiceKey> &services) override;
+
+    /**
+     * @brief Compiles the registrations into an immutable table.
+     *
+     * After freezing, lookups take no lock, and registering or unregistering
+     * services fails with a warning.
+     * @return True, the default container always supports freezing.
+     */
+    bool freeze() override;
 };
 }
 #endif // DEFAULT_SERVICES_H
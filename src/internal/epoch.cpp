@@ -0,0 +1,99 @@
+/**
+ * @file epoch.cpp
+ * @brief This file is for internal use only and must not be in final release in include directories.
+ */
+
+#include "internal/epoch.h"
+
+#include <atomic>
+
+namespace PureIOC::internal {
+namespace {
+    /**
+     * @brief The epoch a thread announced when it entered its read section.
+     *
+     * Records are linked into a list that only grows, and are reused by new
+     * threads once their owner exits, so the list is as long as the largest
+     * number of threads that ever ran at once. Zero means the owner is not
+     * inside a read section.
+     */
+    struct Record {
+        std::atomic<std::uint64_t> epoch{0};
+        std::atomic<bool> used{true};
+        Record *next = nullptr;
+        unsigned depth = 0; ///< The number of nested sections of the owner; only the owner touches it.
+    };
+
+    std::atomic<std::uint64_t> g_epoch{1}; ///< The current epoch.
+    std::atomic<Record *> g_records{nullptr}; ///< The records of every thread, newest first; never freed.
+
+    /**
+     * @brief Owns the record of a thread for the thread's lifetime.
+     */
+    struct RecordOwner {
+        Record *record;
+
+        RecordOwner() {
+            for (record = g_records.load(std::memory_order_acquire); record; record = record->next) {
+                bool free = false;
+                if (!record->used.load(std::memory_order_relaxed)
+                    && record->used.compare_exchange_strong(free, true, std::memory_order_acquire)) {
+                    return;
+                }
+            }
+
+            record = new Record();
+            record->next = g_records.load(std::memory_order_relaxed);
+            while (!g_records.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+
+        ~RecordOwner() {
+            record->epoch.store(0, std::memory_order_release);
+            record->used.store(false, std::memory_order_release);
+        }
+
+        RecordOwner(const RecordOwner &) = delete;
+        RecordOwner &operator=(const RecordOwner &) = delete;
+    };
+
+    Record &threadRecord() {
+        thread_local RecordOwner owner;
+        return *owner.record;
+    }
+}
+
+void enterEpoch() noexcept {
+    Record &record = threadRecord();
+    if (record.depth++ == 0) {
+        record.epoch.store(g_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+bool leaveEpoch() noexcept {
+    Record &record = threadRecord();
+    if (--record.depth != 0) {
+        return false;
+    }
+
+    record.epoch.store(0, std::memory_order_release);
+    return true;
+}
+
+std::uint64_t advanceEpoch() noexcept {
+    return g_epoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+}
+
+bool epochReached(std::uint64_t epoch) noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (const Record *record = g_records.load(std::memory_order_acquire); record; record = record->next) {
+        const std::uint64_t announced = record->epoch.load(std::memory_order_acquire);
+        if (announced && announced < epoch) {
+            return false;
+        }
+    }
+
+    return true;
+}
+}
@@ -0,0 +1,68 @@
+/**
+ * @file epoch.h
+ * @brief This file is for internal use only and must not be in final release in include directories.
+ */
+
+#ifndef EPOCH_H
+#define EPOCH_H
+#pragma once
+#include <cstdint>
+
+namespace PureIOC::internal {
+/**
+ * @brief Enters the calling thread into an epoch-protected read section.
+ *
+ * An object published through an atomic pointer and read between
+ * enterEpoch() and the matching leaveEpoch() stays valid even if a writer
+ * unpublishes it meanwhile. The thread announces the current epoch in a
+ * record of its own, so entering touches no shared cache line but the epoch
+ * counter. Sections nest; only the outermost one announces an epoch. Load
+ * the published pointer after entering, with at least acquire ordering.
+ * @internal
+ */
+void enterEpoch() noexcept;
+
+/**
+ * @brief Leaves the read section entered by the matching enterEpoch().
+ * @return True if the thread left its outermost section.
+ * @internal
+ */
+bool leaveEpoch() noexcept;
+
+/**
+ * @brief Advances the epoch after an object was unpublished.
+ *
+ * The object may be destroyed once epochReached() returns true for the
+ * returned epoch.
+ * @return The epoch the object was retired in.
+ * @internal
+ */
+std::uint64_t advanceEpoch() noexcept;
+
+/**
+ * @brief Checks whether objects retired in an epoch can no longer be read.
+ * @param epoch The epoch the objects were retired in, as returned by advanceEpoch().
+ * @return True if every thread inside a read section entered it in that epoch or later.
+ * @internal
+ */
+bool epochReached(std::uint64_t epoch) noexcept;
+
+/**
+ * @brief Keeps the calling thread inside an epoch-protected read section while alive.
+ * @internal
+ */
+class EpochGuard {
+public:
+    EpochGuard() noexcept {
+        enterEpoch();
+    }
+
+    ~EpochGuard() {
+        leaveEpoch();
+    }
+
+    EpochGuard(const EpochGuard &) = delete;
+    EpochGuard &operator=(const EpochGuard &) = delete;
+};
+}
+#endif // EPOCH_H
@@ -0,0 +1,230 @@
+/**
+ * @file intern-table.h
+ * @brief This file is for internal use only and must not be in final release in include directories.
+ */
+
+#ifndef INTERN_TABLE_H
+#define INTERN_TABLE_H
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace PureIOC::internal {
+/**
+ * @class InternTable
+ * @brief Assigns dense ids, starting at zero, to keys on first use; lookups take no lock.
+ *
+ * Keys live in nodes that are never moved or freed before the table. Keys
+ * are hashed to one of several independently locked shards, each with its
+ * own key-to-id index: an open-addressing array of node pointers, published
+ * through an atomic pointer and replaced by a copy twice as large when it is
+ * half full. Replaced arrays are kept until the table is destroyed, so
+ * readers never need to pin them. Nodes are found by id through segments
+ * that double in size, with two loads. Only interning a new key locks, and
+ * only its shard, so new keys interned concurrently rarely contend.
+ * @tparam K The type of the stored keys.
+ * @tparam V The type the keys are looked up, hashed and compared as.
+ * @internal
+ */
+template <class K, class V = K>
+class InternTable {
+private:
+    struct Node {
+        K key;
+        std::size_t id;
+    };
+
+    struct Index {
+        std::size_t mask;
+        std::unique_ptr<std::atomic<const Node *>[]> slots;
+
+        explicit Index(std::size_t capacity)
+            : mask(capacity - 1), slots(new std::atomic<const Node *>[capacity]) {
+            for (std::size_t i = 0; i < capacity; ++i) {
+                slots[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    /**
+     * @brief A share of the keys, with its own lock and index.
+     */
+    struct alignas(64) Shard {
+        std::mutex mutex; ///< Serializes interning into the shard.
+        std::atomic<const Index *> index{nullptr};
+        std::vector<std::unique_ptr<Index>> indices; ///< The current and the replaced indices.
+        std::deque<Node> nodes; ///< Owns the nodes of the shard.
+    };
+
+    static constexpr std::size_t FirstSegmentBits = 6;
+    static constexpr std::size_t Segments = 32;
+    static constexpr std::size_t ShardBits = 5;
+
+    std::array<Shard, std::size_t(1) << ShardBits> _shards;
+    std::atomic<std::size_t> _size{0}; ///< The next id to assign.
+    std::array<std::atomic<std::atomic<const Node *> *>, Segments> _segments{};
+
+    static std::size_t hash(V key) noexcept {
+        return std::hash<V>{}(key) * 0x9e3779b97f4a7c15ULL;
+    }
+
+    Shard &shardOf(std::size_t hash) noexcept {
+        return _shards[hash >> (sizeof(std::size_t) * 8 - ShardBits)];
+    }
+
+    const Shard &shardOf(std::size_t hash) const noexcept {
+        return _shards[hash >> (sizeof(std::size_t) * 8 - ShardBits)];
+    }
+
+    /**
+     * @brief Locates an id in the segments.
+     * @param id The id.
+     * @return The segment and the offset in it.
+     */
+    static std::pair<std::size_t, std::size_t> locate(std::size_t id) noexcept {
+        const std::size_t n = id + (std::size_t(1) << FirstSegmentBits);
+        std::size_t bits = 0;
+        while ((n >> bits) > 1) {
+            ++bits;
+        }
+
+        const std::size_t segment = bits - FirstSegmentBits;
+        return {segment, n - (std::size_t(1) << bits)};
+    }
+
+    static void insert(const Index &index, const Node *node) noexcept {
+        std::size_t slot = hash(V(node->key)) & index.mask;
+        while (index.slots[slot].load(std::memory_order_relaxed)) {
+            slot = (slot + 1) & index.mask;
+        }
+        index.slots[slot].store(node, std::memory_order_release);
+    }
+
+    /**
+     * @brief Makes room for one more key in a shard, replacing its index if it is half full.
+     *
+     * Must be called with the mutex of the shard held.
+     * @param shard The shard.
+     */
+    static void reserve(Shard &shard) {
+        const Index *current = shard.index.load(std::memory_order_relaxed);
+        if (current && (shard.nodes.size() + 1) * 2 <= current->mask + 1) {
+            return;
+        }
+
+        auto larger = std::make_unique<Index>(current ? (current->mask + 1) * 2 : std::size_t(1) << FirstSegmentBits);
+        for (const Node &node : shard.nodes) {
+            insert(*larger, &node);
+        }
+        shard.index.store(larger.get(), std::memory_order_release);
+        shard.indices.push_back(std::move(larger));
+    }
+
+    /**
+     * @brief Records a node under its id.
+     *
+     * Segments are allocated by whichever shard needs them first.
+     * @param node The node.
+     */
+    void publish(const Node &node) {
+        const auto [segment, offset] = locate(node.id);
+        std::atomic<const Node *> *nodes = _segments[segment].load(std::memory_order_acquire);
+        if (!nodes) {
+            const std::size_t size = std::size_t(1) << (segment + FirstSegmentBits);
+            auto allocated = std::make_unique<std::atomic<const Node *>[]>(size);
+            for (std::size_t i = 0; i < size; ++i) {
+                allocated[i].store(nullptr, std::memory_order_relaxed);
+            }
+            if (_segments[segment].compare_exchange_strong(nodes, allocated.get(), std::memory_order_acq_rel)) {
+                nodes = allocated.release();
+            }
+        }
+        nodes[offset].store(&node, std::memory_order_release);
+    }
+
+public:
+    InternTable() = default;
+
+    ~InternTable() {
+        for (auto &segment : _segments) {
+            delete[] segment.load(std::memory_order_relaxed);
+        }
+    }
+
+    InternTable(const InternTable &) = delete;
+    InternTable &operator=(const InternTable &) = delete;
+
+    /**
+     * @brief Finds the id of a key without interning it.
+     * @param key The key.
+     * @return The id, or std::nullopt if the key was not interned.
+     */
+    std::optional<std::size_t> find(V key) const noexcept {
+        const std::size_t hashed = hash(key);
+        const Index *index = shardOf(hashed).index.load(std::memory_order_acquire);
+        if (!index) {
+            return std::nullopt;
+        }
+
+        for (std::size_t slot = hashed & index->mask;; slot = (slot + 1) & index->mask) {
+            const Node *node = index->slots[slot].load(std::memory_order_acquire);
+            if (!node) {
+                return std::nullopt;
+            }
+            if (V(node->key) == key) {
+                return node->id;
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the id of a key, interning it on first use.
+     * @param key The key.
+     * @return The id.
+     */
+    std::size_t intern(V key) {
+        if (std::optional<std::size_t> id = find(key)) {
+            return *id;
+        }
+
+        Shard &shard = shardOf(hash(key));
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (std::optional<std::size_t> id = find(key)) {
+            return *id;
+        }
+
+        reserve(shard);
+        const std::size_t id = _size.fetch_add(1, std::memory_order_relaxed);
+        const Node &node = shard.nodes.emplace_back(Node{K(key), id});
+        publish(node);
+        insert(*shard.index.load(std::memory_order_relaxed), &node);
+
+        return id;
+    }
+
+    /**
+     * @brief Gets the key an id was assigned to.
+     * @param id The id.
+     * @return The key, or nullptr if the id was never assigned.
+     */
+    const K *get(std::size_t id) const noexcept {
+        const auto [segment, offset] = locate(id);
+        if (segment >= Segments) {
+            return nullptr;
+        }
+
+        const std::atomic<const Node *> *nodes = _segments[segment].load(std::memory_order_acquire);
+        const Node *node = nodes ? nodes[offset].load(std::memory_order_acquire) : nullptr;
+        return node ? &node->key : nullptr;
+    }
+};
+}
+#endif // INTERN_TABLE_H
@@ -14,7 +14,7 @@ namespace PureIOC {
  * @return True if the service was registered, false otherwise.
  */
 bool registerService(const std::type_index &type, std::function<std::any()> factory) {
-    return getContainer()->registerService(type, std::move(factory));
+    return currentContainer()->registerService(type, std::move(factory));
 }
 
 /**
@@ -25,7 +25,7 @@ bool registerService(const std::type_index &type, std::function<std::any()> fact
  * @return True if the service was registered, false otherwise.
  */
 bool registerService(const std::type_index &type, const std::string &contract, std::function<std::any()> factory) {
-    return getContainer()->registerService(type, contract, std::move(factory));
+    return currentContainer()->registerService(type, contract, std::move(factory));
 }
 
 /**
@@ -35,7 +35,7 @@ bool registerService(const std::type_index &type, const std::string &contract, s
  * @return True if the service was registered, false otherwise.
  */
 bool registerLazySingleton(const std::type_index &type, std::function<std::any()> factory) {
-    return getContainer()->registerLazySingleton(type, std::move(factory));
+    return currentContainer()->registerLazySingleton(type, std::move(factory));
 }
 
 /**
@@ -46,7 +46,7 @@ bool registerLazySingleton(const std::type_index &type, std::function<std::any()
  * @return True if the service was registered, false otherwise.
  */
 bool registerLazySingleton(const std::type_index &type, const std::string &contract, std::function<std::any()> factory) {
-    return getContainer()->registerLazySingleton(type, contract, std::move(factory));
+    return currentContainer()->registerLazySingleton(type, contract, std::move(factory));
 }
 
 /**
@@ -56,7 +56,7 @@ bool registerLazySingleton(const std::type_index &type, const std::string &contr
  * @return True if the service was registered, false otherwise.
  */
 bool registerConstant(const std::type_index &type, std::any service) {
-    return getContainer()->registerConstant(type, std::move(service));
+    return currentContainer()->registerConstant(type, std::move(service));
 }
 
 /**
@@ -67,7 +67,72 @@ bool registerConstant(const std::type_index &type, std::any service) {
  * @return True if the service was registered, false otherwise.
  */
 bool registerConstant(const std::type_index &type, const std::string &contract, std::any service) {
-    return getContainer()->registerConstant(type, contract, std::move(service));
+    return currentContainer()->registerConstant(type, contract, std::move(service));
+}
+
+/**
+ * @brief Registers a scoped service with the locator.
+ * @param type The type of the service.
+ * @param factory The factory function that creates the service for a scope.
+ * @return True if the service was registered, false otherwise.
+ */
+bool registerScoped(const std::type_index &type, std::function<std::shared_ptr<void>(Scope &)> factory) {
+    return currentContainer()->registerScoped(type, std::move(factory));
+}
+
+/**
+ * @brief Registers a scoped service with the locator with a contract.
+ * @param type The type of the service.
+ * @param contract The contract for the service.
+ * @param factory The factory function that creates the service for a scope.
+ * @return True if the service was registered, false otherwise.
+ */
+bool registerScoped(const std::type_index &type, const std::string &contract, std::function<std::shared_ptr<void>(Scope &)> factory) {
+    return currentContainer()->registerScoped(type, contract, std::move(factory));
+}
+
+/**
+ * @brief Registers the factory of a service with the locator.
+ * @param type The type of the service.
+ * @param lifetime The lifetime of the service.
+ * @param factory The factory.
+ * @return True if the service was registered, false otherwise.
+ */
+bool registerFactory(const std::type_index &type, ServiceLifetime lifetime, ServiceFactory factory) {
+    return currentContainer()->registerFactory(type, lifetime, std::move(factory));
+}
+
+/**
+ * @brief Registers the factory of a service with the locator with a contract.
+ * @param type The type of the service.
+ * @param contract The contract for the service.
+ * @param lifetime The lifetime of the service.
+ * @param factory The factory.
+ * @return True if the service was registered, false otherwise.
+ */
+bool registerFactory(const std::type_index &type, const std::string &contract, ServiceLifetime lifetime, ServiceFactory factory) {
+    return currentContainer()->registerFactory(type, contract, lifetime, std::move(factory));
+}
+
+/**
+ * @brief Registers a pooled service with the locator.
+ * @param type The type of the service.
+ * @param factory The factory function that acquires an instance from the pool.
+ * @return True if the service was registered, false otherwise.
+ */
+bool registerPooled(const std::type_index &type, std::function<std::any()> factory) {
+    return currentContainer()->registerPooled(type, std::move(factory));
+}
+
+/**
+ * @brief Registers a pooled service with the locator with a contract.
+ * @param type The type of the service.
+ * @param contract The contract for the service.
+ * @param factory The factory function that acquires an instance from the pool.
+ * @return True if the service was registered, false otherwise.
+ */
+bool registerPooled(const std::type_index &type, const std::string &contract, std::function<std::any()> factory) {
+    return currentContainer()->registerPooled(type, contract, std::move(factory));
 }
 
 /**
@@ -77,7 +142,7 @@ bool registerConstant(const std::type_index &type, const std::string &contract,
  */
 bool registerLogger(std::shared_ptr<ILogger> logger) {
     std::any logger_any = std::any(std::move(logger));
-    return getContainer()->registerConstant(std::type_index(typeid(ILogger)), std::move(logger_any));
+    return currentContainer()->registerConstant(std::type_index(typeid(ILogger)), std::move(logger_any));
 }
 
 /**
@@ -85,7 +150,7 @@ bool registerLogger(std::shared_ptr<ILogger> logger) {
  * @param type The type of the service to unregister.
  */
 void unregister(const std::type_index &type) {
-    getContainer()->unregisterService(type);
+    currentContainer()->unregisterService(type);
 }
 
 /**
@@ -94,7 +159,23 @@ void unregister(const std::type_index &type) {
  * @param contract The contract associated with the service.
  */
 void unregister(const std::type_index &type, const std::string &contract) {
-    getContainer()->unregisterService(type, contract);
+    currentContainer()->unregisterService(type, contract);
+}
+
+/**
+ * @brief Unregisters several services from the locator at once.
+ * @param services The services to unregister.
+ */
+void unregisterAll(const std::vector<ServiceKey> &services) {
+    currentContainer()->unregisterAll(services);
+}
+
+/**
+ * @brief Freezes the registrations of the global service container.
+ * @return True if the container is frozen, false if it does not support freezing.
+ */
+bool freeze() {
+    return currentContainer()->freeze();
 }
 
 /**
@@ -7,14 +7,19 @@
 #define LOCATOR_MUTABLE_H
 #pragma once
 #include <memory>
+#include <memory_resource>
 #include <functional>
+#include <tuple>
 #include <typeindex>
 #include <string>
 #include <utility>
 #include <typeinfo>
 #include <any>
 #include <type_traits>
+#include <vector>
 
+#include "scope.h"
+#include "service-pool.h"
 #include "services-interface.h"
 #include "logger-interface.h"
 
@@ -65,6 +70,56 @@ bool registerConstant(const std::type_index &type, std::any service);
  */
 bool registerConstant(const std::type_index &type, const std::string &contract, std::any service);
 
+/**
+ * @brief Registers a scoped service with the locator.
+ * @param type The type of the service.
+ * @param factory The factory function that creates the service for a scope.
+ * @return True if the service was registered, false otherwise.
+ */
+bool registerScoped(const std::type_index &type, std::function<std::shared_ptr<void>(Scope &)> factory);
+/**
+ * @brief Registers a scoped service with the locator with a contract.
+ * @param type The type of the service.
+ * @param contract The contract for the service.
+ * @param factory The factory function that creates the service for a scope.
+ * @return True if the service was registered, false otherwise.
+ */
+bool registerScoped(const std::type_index &type, const std::string &contract, std::function<std::shared_ptr<void>(Scope &)> factory);
+
+/**
+ * @brief Registers the factory of a service with the locator.
+ * @param type The type of the service.
+ * @param lifetime The lifetime of the service: Transient, LazySingleton or Pooled.
+ * @param factory The factory.
+ * @return True if the service was registered, false otherwise.
+ */
+bool registerFactory(const std::type_index &type, ServiceLifetime lifetime, ServiceFactory factory);
+/**
+ * @brief Registers the factory of a service with the locator with a contract.
+ * @param type The type of the service.
+ * @param contract The contract for the service.
+ * @param lifetime The lifetime of the service: Transient, LazySingleton or Pooled.
+ * @param factory The factory.
+ * @return True if the service was registered, false otherwise.
+ */
+bool registerFactory(const std::type_index &type, const std::string &contract, ServiceLifetime lifetime, ServiceFactory factory);
+
+/**
+ * @brief Registers a pooled service with the locator.
+ * @param type The type of the service.
+ * @param factory The factory function that acquires an instance from the pool.
+ * @return True if the service was registered, false otherwise.
+ */
+bool registerPooled(const std::type_index &type, std::function<std::any()> factory);
+/**
+ * @brief Registers a pooled service with the locator with a contract.
+ * @param type The type of the service.
+ * @param contract The contract for the service.
+ * @param factory The factory function that acquires an instance from the pool.
+ * @return True if the service was registered, false otherwise.
+ */
+bool registerPooled(const std::type_index &type, const std::string &contract, std::function<std::any()> factory);
+
 /**
  * @brief Registers a logger with the locator.
  * @param logger The logger instance.
@@ -85,6 +140,25 @@ void unregister(const std::type_index &type);
  */
 void unregister(const std::type_index &type, const std::string &contract);
 
+/**
+ * @brief Unregisters several services from the locator at once.
+ *
+ * The default container removes them under a single lock, so no other
+ * thread sees some of them gone and others still registered.
+ * @param services The services to unregister.
+ */
+void unregisterAll(const std::vector<ServiceKey> &services);
+
+/**
+ * @brief Freezes the registrations of the global service container.
+ *
+ * Call once bootstrap is complete. Lookups then take no lock, and further
+ * registrations are rejected until cleanup() or registerContainer() installs
+ * a new container.
+ * @return True if the container is frozen, false if it does not support freezing.
+ */
+bool freeze();
+
 /**
  * @brief Resets the global service container.
  *
@@ -125,6 +199,110 @@ std::function<std::any()> convertFunction(std::function<std::shared_ptr<T>()> fa
     };
 }
 
+namespace detail {
+/**
+ * @brief Checks whether a callable is a factory for services of type RT.
+ *
+ * The callable must be callable as const, since it is stored once and
+ * called in place by every resolving thread. Mutable callables are
+ * converted to a std::function instead, which is copied for each call.
+ * @tparam RT The return type of the factory.
+ * @tparam F The type of the callable.
+ */
+template <class RT, class F>
+constexpr bool isFactory = std::is_invocable_r_v<std::shared_ptr<RT>, const std::decay_t<F> &>;
+
+/**
+ * @brief Wraps a callable into a factory that returns std::any.
+ *
+ * The callable is stored directly in the returned factory, inline unless it
+ * is too large, so creating a service goes through a single indirect call
+ * and registering it needs no heap allocation.
+ * @tparam T The type of the service.
+ * @tparam RT The return type of the factory.
+ * @tparam F The type of the callable.
+ * @param factory The callable.
+ * @return A factory that returns std::any.
+ */
+template <class T, class RT, class F>
+ServiceFactory makeFactory(F &&factory) {
+    static_assert(std::is_convertible_v<RT *, T *>, "RT must be convertible to T");
+
+    if constexpr (std::is_same_v<std::decay_t<F>, std::function<std::shared_ptr<RT>()>>) {
+        // A std::function may wrap a mutable callable, so each call runs on a copy.
+        return [f = std::forward<F>(factory)]() -> std::any {
+            std::shared_ptr<RT> result = std::function<std::shared_ptr<RT>()>(f)();
+            return std::any(std::shared_ptr<T>(std::move(result)));
+        };
+    } else {
+        return [f = std::forward<F>(factory)]() -> std::any {
+            std::shared_ptr<RT> result = f();
+            return std::any(std::shared_ptr<T>(std::move(result)));
+        };
+    }
+}
+
+/**
+ * @brief Checks whether a callable is a scoped factory for services of type RT.
+ * @tparam RT The return type of the factory.
+ * @tparam F The type of the callable.
+ */
+template <class RT, class F>
+constexpr bool isScopedFactory = std::is_invocable_r_v<std::shared_ptr<RT>, std::decay_t<F> &, Scope &>;
+
+/**
+ * @brief Wraps a callable into a scoped factory.
+ * @tparam T The type of the service.
+ * @tparam RT The return type of the factory.
+ * @tparam F The type of the callable.
+ * @param factory The callable, called with the scope that resolves the service.
+ * @return A function that returns the instance as a pointer to T.
+ */
+template <class T, class RT, class F>
+std::function<std::shared_ptr<void>(Scope &)> makeScopedFactory(F &&factory) {
+    static_assert(std::is_convertible_v<RT *, T *>, "RT must be convertible to T");
+
+    return [f = std::forward<F>(factory)](Scope &scope) mutable -> std::shared_ptr<void> {
+        std::shared_ptr<RT> result = f(scope);
+        return std::shared_ptr<T>(std::move(result));
+    };
+}
+}
+
+/**
+ * @brief Creates a service instance in a memory resource.
+ *
+ * The instance and its control block share a single allocation from the
+ * resource, which must outlive the instance.
+ * @tparam RT The type of the instance.
+ * @tparam Args The types of the constructor arguments.
+ * @param resource The memory resource.
+ * @param args The constructor arguments.
+ * @return A shared pointer to the instance.
+ */
+template <class RT, class... Args>
+std::shared_ptr<RT> allocateService(std::pmr::memory_resource *resource, Args &&...args) {
+    return std::allocate_shared<RT>(std::pmr::polymorphic_allocator<RT>(resource), std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Creates a factory that constructs service instances in a memory resource.
+ *
+ * Pass the result to registerService() or registerLazySingleton(); the
+ * arguments are copied into the factory and passed to every instance.
+ * @tparam RT The type of the instances.
+ * @tparam Args The types of the constructor arguments.
+ * @param resource The memory resource, which must outlive every instance.
+ * @param args The constructor arguments.
+ * @return The factory.
+ */
+template <class RT, class... Args>
+auto allocatingFactory(std::pmr::memory_resource *resource, Args &&...args) {
+    return [resource, arguments = std::make_tuple(std::forward<Args>(args)...)]() -> std::shared_ptr<RT> {
+        return std::apply([resource](const auto &...values) { return allocateService<RT>(resource, values...); }, arguments);
+    };
+}
+
 /**
  * @brief Registers a service with the locator.
  * @tparam T The type of the service.
@@ -134,7 +312,7 @@ std::function<std::any()> convertFunction(std::function<std::shared_ptr<T>()> fa
  */
 template <class T, class RT>
 bool registerService(std::function<std::shared_ptr<RT>()> factory) {
-    return registerService(std::type_index(typeid(T)), convertFunction<T, RT>(std::move(factory)));
+    return registerFactory(std::type_index(typeid(T)), ServiceLifetime::Transient, detail::makeFactory<T, RT>(std::move(factory)));
 }
 
 /**
@@ -145,7 +323,7 @@ bool registerService(std::function<std::shared_ptr<RT>()> factory) {
  */
 template <class T>
 bool registerService(std::function<std::shared_ptr<T>()> factory) {
-    return registerService(std::type_index(typeid(T)), convertFunction<T, T>(std::move(factory)));
+    return registerFactory(std::type_index(typeid(T)), ServiceLifetime::Transient, detail::makeFactory<T, T>(std::move(factory)));
 }
 
 /**
@@ -158,7 +336,7 @@ bool registerService(std::function<std::shared_ptr<T>()> factory) {
  */
 template <class T, class RT>
 bool registerService(const std::string &contract, std::function<std::shared_ptr<RT>()> factory) {
-    return registerService(std::type_index(typeid(T)), contract, convertFunction<T, RT>(std::move(factory)));
+    return registerFactory(std::type_index(typeid(T)), contract, ServiceLifetime::Transient, detail::makeFactory<T, RT>(std::move(factory)));
 }
 
 /**
@@ -170,7 +348,7 @@ bool registerService(const std::string &contract, std::function<std::shared_ptr<
  */
 template <class T>
 bool registerService(const std::string &contract, std::function<std::shared_ptr<T>()> factory) {
-    return registerService(std::type_index(typeid(T)), contract, convertFunction<T, T>(std::move(factory)));
+    return registerFactory(std::type_index(typeid(T)), contract, ServiceLifetime::Transient, detail::makeFactory<T, T>(std::move(factory)));
 }
 
 /**
@@ -182,7 +360,7 @@ bool registerService(const std::string &contract, std::function<std::shared_ptr<
  */
 template <class T, class RT>
 bool registerLazySingleton(std::function<std::shared_ptr<RT>()> factory) {
-    return registerLazySingleton(std::type_index(typeid(T)), convertFunction<T, RT>(std::move(factory)));
+    return registerFactory(std::type_index(typeid(T)), ServiceLifetime::LazySingleton, detail::makeFactory<T, RT>(std::move(factory)));
 }
 
 /**
@@ -193,7 +371,7 @@ bool registerLazySingleton(std::function<std::shared_ptr<RT>()> factory) {
  */
 template <class T>
 bool registerLazySingleton(std::function<std::shared_ptr<T>()> factory) {
-    return registerLazySingleton(std::type_index(typeid(T)), convertFunction<T, T>(std::move(factory)));
+    return registerFactory(std::type_index(typeid(T)), ServiceLifetime::LazySingleton, detail::makeFactory<T, T>(std::move(factory)));
 }
 
 /**
@@ -206,7 +384,7 @@ bool registerLazySingleton(std::function<std::shared_ptr<T>()> factory) {
  */
 template <class T, class RT>
 bool registerLazySingleton(const std::string &contract, std::function<std::shared_ptr<RT>()> factory) {
-    return registerLazySingleton(std::type_index(typeid(T)), contract, convertFunction<T,RT>(std::move(factory)));
+    return registerFactory(std::type_index(typeid(T)), contract, ServiceLifetime::LazySingleton, detail::makeFactory<T, RT>(std::move(factory)));
 }
 
 /**
@@ -218,7 +396,209 @@ bool registerLazySingleton(const std::string &contract, std::function<std::share
  */
 template <class T>
 bool registerLazySingleton(const std::string &contract, std::function<std::shared_ptr<T>()> factory) {
-    return registerLazySingleton(std::type_index(typeid(T)), contract, convertFunction<T, T>(std::move(factory)));
+    return registerFactory(std::type_index(typeid(T)), contract, ServiceLifetime::LazySingleton, detail::makeFactory<T, T>(std::move(factory)));
+}
+
+/**
+ * @brief Registers a service with the locator.
+ *
+ * Accepts any callable, such as a lambda, and stores it without first
+ * converting it to a std::function.
+ * @tparam T The type of the service.
+ * @tparam RT The return type of the factory.
+ * @tparam F The type of the factory.
+ * @param factory The factory function.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class RT, class F, std::enable_if_t<detail::isFactory<RT, F>, int> = 0>
+bool registerService(F &&factory) {
+    return registerFactory(std::type_index(typeid(T)), ServiceLifetime::Transient, detail::makeFactory<T, RT>(std::forward<F>(factory)));
+}
+
+/**
+ * @brief Registers a service with the locator.
+ *
+ * Accepts any callable, such as a lambda, and stores it without first
+ * converting it to a std::function.
+ * @tparam T The type of the service.
+ * @tparam F The type of the factory.
+ * @param factory The factory function.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class F, std::enable_if_t<detail::isFactory<T, F>, int> = 0>
+bool registerService(F &&factory) {
+    return registerFactory(std::type_index(typeid(T)), ServiceLifetime::Transient, detail::makeFactory<T, T>(std::forward<F>(factory)));
+}
+
+/**
+ * @brief Registers a service with the locator with a contract.
+ * @tparam T The type of the service.
+ * @tparam RT The return type of the factory.
+ * @tparam F The type of the factory.
+ * @param contract The contract for the service.
+ * @param factory The factory function.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class RT, class F, std::enable_if_t<detail::isFactory<RT, F>, int> = 0>
+bool registerService(const std::string &contract, F &&factory) {
+    return registerFactory(std::type_index(typeid(T)), contract, ServiceLifetime::Transient, detail::makeFactory<T, RT>(std::forward<F>(factory)));
+}
+
+/**
+ * @brief Registers a service with the locator with a contract.
+ * @tparam T The type of the service.
+ * @tparam F The type of the factory.
+ * @param contract The contract for the service.
+ * @param factory The factory function.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class F, std::enable_if_t<detail::isFactory<T, F>, int> = 0>
+bool registerService(const std::string &contract, F &&factory) {
+    return registerFactory(std::type_index(typeid(T)), contract, ServiceLifetime::Transient, detail::makeFactory<T, T>(std::forward<F>(factory)));
+}
+
+/**
+ * @brief Registers a lazy singleton service with the locator.
+ *
+ * Accepts any callable, such as a lambda, and stores it without first
+ * converting it to a std::function.
+ * @tparam T The type of the service.
+ * @tparam RT The return type of the factory.
+ * @tparam F The type of the factory.
+ * @param factory The factory function.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class RT, class F, std::enable_if_t<detail::isFactory<RT, F>, int> = 0>
+bool registerLazySingleton(F &&factory) {
+    return registerFactory(std::type_index(typeid(T)), ServiceLifetime::LazySingleton, detail::makeFactory<T, RT>(std::forward<F>(factory)));
+}
+
+/**
+ * @brief Registers a lazy singleton service with the locator.
+ *
+ * Accepts any callable, such as a lambda, and stores it without first
+ * converting it to a std::function.
+ * @tparam T The type of the service.
+ * @tparam F The type of the factory.
+ * @param factory The factory function.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class F, std::enable_if_t<detail::isFactory<T, F>, int> = 0>
+bool registerLazySingleton(F &&factory) {
+    return registerFactory(std::type_index(typeid(T)), ServiceLifetime::LazySingleton, detail::makeFactory<T, T>(std::forward<F>(factory)));
+}
+
+/**
+ * @brief Registers a lazy singleton service with the locator with a contract.
+ * @tparam T The type of the service.
+ * @tparam RT The return type of the factory.
+ * @tparam F The type of the factory.
+ * @param contract The contract for the service.
+ * @param factory The factory function.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class RT, class F, std::enable_if_t<detail::isFactory<RT, F>, int> = 0>
+bool registerLazySingleton(const std::string &contract, F &&factory) {
+    return registerFactory(std::type_index(typeid(T)), contract, ServiceLifetime::LazySingleton, detail::makeFactory<T, RT>(std::forward<F>(factory)));
+}
+
+/**
+ * @brief Registers a lazy singleton service with the locator with a contract.
+ * @tparam T The type of the service.
+ * @tparam F The type of the factory.
+ * @param contract The contract for the service.
+ * @param factory The factory function.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class F, std::enable_if_t<detail::isFactory<T, F>, int> = 0>
+bool registerLazySingleton(const std::string &contract, F &&factory) {
+    return registerFactory(std::type_index(typeid(T)), contract, ServiceLifetime::LazySingleton, detail::makeFactory<T, T>(std::forward<F>(factory)));
+}
+
+/**
+ * @brief Registers a scoped service with the locator.
+ *
+ * The factory is called once per Scope that resolves the service; use
+ * Scope::make() in it to allocate the instance in the arena of the scope.
+ * @tparam T The type of the service.
+ * @tparam RT The return type of the factory.
+ * @tparam F The type of the factory.
+ * @param factory The factory function, called with the scope.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class RT, class F, std::enable_if_t<detail::isScopedFactory<RT, F>, int> = 0>
+bool registerScoped(F &&factory) {
+    return registerScoped(std::type_index(typeid(T)), detail::makeScopedFactory<T, RT>(std::forward<F>(factory)));
+}
+
+/**
+ * @brief Registers a scoped service with the locator.
+ * @tparam T The type of the service.
+ * @tparam F The type of the factory.
+ * @param factory The factory function, called with the scope.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class F, std::enable_if_t<detail::isScopedFactory<T, F>, int> = 0>
+bool registerScoped(F &&factory) {
+    return registerScoped(std::type_index(typeid(T)), detail::makeScopedFactory<T, T>(std::forward<F>(factory)));
+}
+
+/**
+ * @brief Registers a scoped service with the locator with a contract.
+ * @tparam T The type of the service.
+ * @tparam RT The return type of the factory.
+ * @tparam F The type of the factory.
+ * @param contract The contract for the service.
+ * @param factory The factory function, called with the scope.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class RT, class F, std::enable_if_t<detail::isScopedFactory<RT, F>, int> = 0>
+bool registerScoped(const std::string &contract, F &&factory) {
+    return registerScoped(std::type_index(typeid(T)), contract, detail::makeScopedFactory<T, RT>(std::forward<F>(factory)));
+}
+
+/**
+ * @brief Registers a scoped service with the locator with a contract.
+ * @tparam T The type of the service.
+ * @tparam F The type of the factory.
+ * @param contract The contract for the service.
+ * @param factory The factory function, called with the scope.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T, class F, std::enable_if_t<detail::isScopedFactory<T, F>, int> = 0>
+bool registerScoped(const std::string &contract, F &&factory) {
+    return registerScoped(std::type_index(typeid(T)), contract, detail::makeScopedFactory<T, T>(std::forward<F>(factory)));
+}
+
+/**
+ * @brief Registers a pooled service with the locator.
+ *
+ * Every resolution takes an instance from the pool; releasing the last
+ * shared pointer to it resets the instance and returns it to the pool. Keep
+ * the pool to read its counters.
+ * @tparam T The type of the service.
+ * @param pool The pool.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T>
+bool registerPooled(std::shared_ptr<ServicePool<T>> pool) {
+    return registerFactory(std::type_index(typeid(T)), ServiceLifetime::Pooled, [pool = std::move(pool)]() -> std::any {
+        return std::any(pool->acquire());
+    });
+}
+
+/**
+ * @brief Registers a pooled service with the locator with a contract.
+ * @tparam T The type of the service.
+ * @param contract The contract for the service.
+ * @param pool The pool.
+ * @return True if the service was registered, false otherwise.
+ */
+template <class T>
+bool registerPooled(const std::string &contract, std::shared_ptr<ServicePool<T>> pool) {
+    return registerFactory(std::type_index(typeid(T)), contract, ServiceLifetime::Pooled, [pool = std::move(pool)]() -> std::any {
+        return std::any(pool->acquire());
+    });
 }
 
 /**
@@ -8,10 +8,48 @@
 
 namespace PureIOC {
 std::optional<std::any> getService(std::type_index type) {
-    return getContainer()->getService(type);
+    return currentContainer()->getService(type);
 }
 
 std::optional<std::any> getService(std::type_index type, const std::string &contract) {
-    return getContainer()->getService(type, contract);
+    return currentContainer()->getService(type, contract);
+}
+
+std::optional<std::any> getService(std::size_t slot, std::type_index type) {
+    return currentContainer()->getService(slot, type);
+}
+
+std::optional<std::any> getService(std::size_t slot, std::type_index type, std::string_view contract) {
+    return currentContainer()->getService(slot, type, contract);
+}
+
+std::optional<std::any> getService(std::size_t slot, std::type_index type, ContractId contract) {
+    return currentContainer()->getService(slot, type, contract);
+}
+
+const std::any *borrowService(std::size_t slot, std::type_index type, ContractId contract) {
+    return currentContainer()->borrowService(slot, type, contract);
+}
+
+std::shared_ptr<ServiceEntry> getEntry(std::size_t slot, std::type_index type, ContractId contract) {
+    return currentContainer()->getEntry(slot, type, contract);
+}
+
+void getServices(const ServiceRequest *requests, std::optional<std::any> *results, std::size_t count) {
+    currentContainer()->getServices(requests, results, count);
+}
+
+bool isCacheable(std::type_index type) {
+    std::optional<ServiceLifetime> lifetime = currentContainer()->getLifetime(type);
+    return lifetime && (*lifetime == ServiceLifetime::Constant || *lifetime == ServiceLifetime::LazySingleton);
+}
+
+bool isCacheable(std::type_index type, const std::string &contract) {
+    std::optional<ServiceLifetime> lifetime = currentContainer()->getLifetime(type, contract);
+    return lifetime && (*lifetime == ServiceLifetime::Constant || *lifetime == ServiceLifetime::LazySingleton);
+}
+
+bool isCacheable(std::type_index type, ContractId contract) {
+    return isCacheable(type, contractName(contract));
 }
 }
@@ -7,10 +7,21 @@
 #define LOCATOR_H
 #pragma once
 #include <any>
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <tuple>
 #include <typeindex>
 #include <string>
+#include <string_view>
 #include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "container-manager.h"
+#include "contract-id.h"
+#include "service-slot.h"
 
 namespace PureIOC {
 /**
@@ -26,6 +37,199 @@ std::optional<std::any> getService(std::type_index type);
  * @return An optional containing the service if found.
  */
 std::optional<std::any> getService(std::type_index type, const std::string &contract);
+/**
+ * @brief Gets a service from the locator using the precomputed slot of its type.
+ * @param slot The slot of the type, as returned by typeSlot().
+ * @param type The type of the service.
+ * @return An optional containing the service if found.
+ */
+std::optional<std::any> getService(std::size_t slot, std::type_index type);
+/**
+ * @brief Gets a service from the locator using the precomputed slot of its type and a contract view.
+ * @param slot The slot of the type, as returned by typeSlot().
+ * @param type The type of the service.
+ * @param contract The contract for the service.
+ * @return An optional containing the service if found.
+ */
+std::optional<std::any> getService(std::size_t slot, std::type_index type, std::string_view contract);
+/**
+ * @brief Gets a service from the locator using the precomputed slot of its type and an interned contract.
+ * @param slot The slot of the type, as returned by typeSlot().
+ * @param type The type of the service.
+ * @param contract The interned contract for the service.
+ * @return An optional containing the service if found.
+ */
+std::optional<std::any> getService(std::size_t slot, std::type_index type, ContractId contract);
+/**
+ * @brief Borrows the shared instance of a constant or lazy singleton from the locator.
+ * @param slot The slot of the type, as returned by typeSlot().
+ * @param type The type of the service.
+ * @param contract The interned contract for the service.
+ * @return The instance, or nullptr if the service is not registered, is transient, or cannot be borrowed.
+ */
+const std::any *borrowService(std::size_t slot, std::type_index type, ContractId contract);
+
+/**
+ * @brief Gets the registration entry of a service from the locator.
+ * @param slot The slot of the type, as returned by typeSlot().
+ * @param type The type of the service.
+ * @param contract The interned contract for the service.
+ * @return The entry, or nullptr if the service is not registered or the container exposes no entries.
+ */
+std::shared_ptr<ServiceEntry> getEntry(std::size_t slot, std::type_index type, ContractId contract);
+
+/**
+ * @brief Gets several services from the locator with a single container access.
+ * @param requests The services to get.
+ * @param results Receives an optional containing each service if found, in the order of the requests.
+ * @param count The number of requests.
+ */
+void getServices(const ServiceRequest *requests, std::optional<std::any> *results, std::size_t count);
+
+/**
+ * @brief Checks whether a resolved service may be cached by the caller.
+ * @param type The type of the service.
+ * @return True if the service is a constant or a lazy singleton.
+ */
+bool isCacheable(std::type_index type);
+/**
+ * @brief Checks whether a resolved service with a contract may be cached by the caller.
+ * @param type The type of the service.
+ * @param contract The contract for the service.
+ * @return True if the service is a constant or a lazy singleton.
+ */
+bool isCacheable(std::type_index type, const std::string &contract);
+/**
+ * @brief Checks whether a resolved service with an interned contract may be cached by the caller.
+ * @param type The type of the service.
+ * @param contract The interned contract for the service.
+ * @return True if the service is a constant or a lazy singleton.
+ */
+bool isCacheable(std::type_index type, ContractId contract);
+
+namespace detail {
+/**
+ * @brief A resolved service cached by a thread, valid for one services generation.
+ * @tparam T The type of the service.
+ */
+template <class T>
+struct CachedService {
+    std::uint64_t generation = 0;
+    std::shared_ptr<T> service;
+};
+
+/**
+ * @brief Maps each service type of resolveAll() to the type of its contract.
+ * @tparam T The type of the service.
+ */
+template <class T>
+struct ContractFor {
+    using type = ContractId;
+};
+
+/**
+ * @brief Gets several services with a single container access.
+ * @tparam Ts The types of the services.
+ * @tparam Is The indices of the services.
+ * @param contracts The interned contracts for the services.
+ * @return A tuple of shared pointers to the services, each nullptr if not found.
+ */
+template <class... Ts, std::size_t... Is>
+std::tuple<std::shared_ptr<Ts>...> resolveAll(const std::array<ContractId, sizeof...(Ts)> &contracts, std::index_sequence<Is...>) {
+    const std::array<ServiceRequest, sizeof...(Ts)> requests{{ServiceRequest{typeSlot<Ts>(), std::type_index(typeid(Ts)), contracts[Is]}...}};
+    std::array<std::optional<std::any>, sizeof...(Ts)> results;
+    ::PureIOC::getServices(requests.data(), results.data(), requests.size());
+
+    return std::tuple<std::shared_ptr<Ts>...>(
+        (results[Is].has_value() ? std::any_cast<std::shared_ptr<Ts>>(*results[Is]) : nullptr)...);
+}
+}
+
+/**
+ * @brief A non-owning reference to a service held by the container.
+ *
+ * A borrowed reference does not share ownership of the service, so obtaining
+ * and copying it never touches a reference count. It stays usable only while
+ * the services generation it was borrowed in is current; callers must check
+ * valid() again after anything that may register or unregister services or
+ * replace the container.
+ * @tparam T The type of the service.
+ */
+template <class T>
+class Borrowed {
+private:
+    T *_service = nullptr;
+    std::uint64_t _generation = 0;
+
+public:
+    /**
+     * @brief Constructs an empty reference.
+     */
+    Borrowed() noexcept = default;
+    /**
+     * @brief Constructs a reference to a service.
+     * @param service The service.
+     * @param generation The services generation the service was borrowed in.
+     */
+    Borrowed(T *service, std::uint64_t generation) noexcept
+        : _service(service), _generation(generation) {}
+
+    /**
+     * @brief Gets the referenced service.
+     * @return The service, or nullptr if the reference is empty.
+     */
+    T *get() const noexcept {
+        return _service;
+    }
+
+    T &operator*() const noexcept {
+        return *_service;
+    }
+
+    T *operator->() const noexcept {
+        return _service;
+    }
+
+    /**
+     * @brief Checks whether the reference is not empty.
+     * @return True if a service was borrowed.
+     */
+    explicit operator bool() const noexcept {
+        return _service != nullptr;
+    }
+
+    /**
+     * @brief Gets the services generation the service was borrowed in.
+     * @return The generation.
+     */
+    std::uint64_t generation() const noexcept {
+        return _generation;
+    }
+
+    /**
+     * @brief Checks whether the referenced service may still be used.
+     * @return True if the reference is not empty and no registration changed since it was borrowed.
+     */
+    bool valid() const noexcept {
+        return _service != nullptr && _generation == servicesGeneration();
+    }
+};
+
+namespace detail {
+/**
+ * @brief Borrows a service and wraps it in a reference for the given generation.
+ * @tparam T The type of the service.
+ * @param contract The interned contract for the service.
+ * @param generation The services generation observed before the lookup.
+ * @return The reference, empty if the service cannot be borrowed.
+ */
+template <class T>
+Borrowed<T> borrowService(ContractId contract, std::uint64_t generation) {
+    const std::any *service = ::PureIOC::borrowService(typeSlot<T>(), std::type_index(typeid(T)), contract);
+    const std::shared_ptr<T> *pointer = service ? std::any_cast<std::shared_ptr<T>>(service) : nullptr;
+    return pointer ? Borrowed<T>(pointer->get(), generation) : Borrowed<T>();
+}
+}
 
 /**
  * @brief Gets a service from the locator.
@@ -34,7 +238,7 @@ std::optional<std::any> getService(std::type_index type, const std::string &cont
  */
 template <class T>
 std::shared_ptr<T> getService() {
-    std::optional<std::any> service = getService(std::type_index(typeid(T)));
+    std::optional<std::any> service = getService(typeSlot<T>(), std::type_index(typeid(T)));
     if (!service.has_value()) {
         return nullptr;
     }
@@ -44,18 +248,189 @@ std::shared_ptr<T> getService() {
 
 /**
  * @brief Gets a service from the locator with a contract.
+ *
+ * The contract is passed down as a view, so string literals and views are
+ * never copied into a std::string by the default container.
  * @tparam T The type of the service.
  * @param contract The contract for the service.
  * @return A shared pointer to the service, or nullptr if not found.
  */
 template <class T>
-std::shared_ptr<T> getService(const std::string &contract) {
-    std::optional<std::any> service = getService(std::type_index(typeid(T)), contract);
+std::shared_ptr<T> getService(std::string_view contract) {
+    std::optional<std::any> service = getService(typeSlot<T>(), std::type_index(typeid(T)), contract);
     if (!service.has_value()) {
         return nullptr;
     }
 
     return std::any_cast<std::shared_ptr<T>>(*service);
 };
+
+/**
+ * @brief Gets a service from the locator with an interned contract.
+ * @tparam T The type of the service.
+ * @param contract The interned contract for the service, see internContract().
+ * @return A shared pointer to the service, or nullptr if not found.
+ */
+template <class T>
+std::shared_ptr<T> getService(ContractId contract) {
+    std::optional<std::any> service = getService(typeSlot<T>(), std::type_index(typeid(T)), contract);
+    if (!service.has_value()) {
+        return nullptr;
+    }
+
+    return std::any_cast<std::shared_ptr<T>>(*service);
+};
+
+/**
+ * @brief Gets several services from the locator at once.
+ *
+ * The services are looked up with a single container access, in one
+ * consistent view of the registrations, so a registration or unregistration
+ * racing with the call is seen by all of them or by none.
+ * @tparam Ts The types of the services.
+ * @return A tuple of shared pointers to the services, each nullptr if not found.
+ */
+template <class... Ts>
+std::tuple<std::shared_ptr<Ts>...> resolveAll() {
+    static_assert(sizeof...(Ts) > 0, "resolveAll needs at least one service type");
+    return detail::resolveAll<Ts...>(std::array<ContractId, sizeof...(Ts)>(), std::index_sequence_for<Ts...>());
+}
+
+/**
+ * @brief Gets several services with interned contracts from the locator at once.
+ * @tparam Ts The types of the services.
+ * @param contracts The interned contract for each service, see internContract(); the "no contract" id for none.
+ * @return A tuple of shared pointers to the services, each nullptr if not found.
+ */
+template <class... Ts>
+std::tuple<std::shared_ptr<Ts>...> resolveAll(typename detail::ContractFor<Ts>::type... contracts) {
+    static_assert(sizeof...(Ts) > 0, "resolveAll needs at least one service type");
+    return detail::resolveAll<Ts...>(std::array<ContractId, sizeof...(Ts)>{{contracts...}}, std::index_sequence_for<Ts...>());
+}
+
+/**
+ * @brief Gets a service from the locator through a thread-local cache.
+ *
+ * Constants and lazy singletons are cached per thread and reused until the
+ * services generation changes, so repeated calls neither reach the container
+ * nor take any lock. Transient services are resolved on every call.
+ * @tparam T The type of the service.
+ * @return A shared pointer to the service, or nullptr if not found.
+ */
+template <class T>
+std::shared_ptr<T> getCachedService() {
+    thread_local detail::CachedService<T> cached;
+    const std::uint64_t generation = servicesGeneration();
+    if (cached.generation == generation) {
+        return cached.service;
+    }
+
+    std::shared_ptr<T> service = getService<T>();
+    if (service && isCacheable(std::type_index(typeid(T)))) {
+        cached = detail::CachedService<T>{generation, service};
+    } else {
+        cached = detail::CachedService<T>{};
+    }
+
+    return service;
+}
+
+/**
+ * @brief Gets a service from the locator with a contract through a thread-local cache.
+ * @tparam T The type of the service.
+ * @param contract The contract for the service.
+ * @return A shared pointer to the service, or nullptr if not found.
+ */
+template <class T>
+std::shared_ptr<T> getCachedService(const std::string &contract) {
+    thread_local std::unordered_map<std::string, detail::CachedService<T>> cache;
+    const std::uint64_t generation = servicesGeneration();
+    auto it = cache.find(contract);
+    if (it != cache.end() && it->second.generation == generation) {
+        return it->second.service;
+    }
+
+    std::shared_ptr<T> service = getService<T>(contract);
+    if (service && isCacheable(std::type_index(typeid(T)), contract)) {
+        cache[contract] = detail::CachedService<T>{generation, service};
+    } else if (it != cache.end()) {
+        cache.erase(it);
+    }
+
+    return service;
+}
+
+/**
+ * @brief Gets a service from the locator with an interned contract through a thread-local cache.
+ *
+ * The cache is indexed by contract id, so a hit costs the same as for an
+ * uncontracted service.
+ * @tparam T The type of the service.
+ * @param contract The interned contract for the service, see internContract().
+ * @return A shared pointer to the service, or nullptr if not found.
+ */
+template <class T>
+std::shared_ptr<T> getCachedService(ContractId contract) {
+    thread_local std::vector<detail::CachedService<T>> cache;
+    const std::uint64_t generation = servicesGeneration();
+    if (contract.value() < cache.size() && cache[contract.value()].generation == generation) {
+        return cache[contract.value()].service;
+    }
+
+    std::shared_ptr<T> service = getService<T>(contract);
+    if (contract.value() >= cache.size()) {
+        cache.resize(contract.value() + 1);
+    }
+    if (service && isCacheable(std::type_index(typeid(T)), contract)) {
+        cache[contract.value()] = detail::CachedService<T>{generation, service};
+    } else {
+        cache[contract.value()] = detail::CachedService<T>{};
+    }
+
+    return service;
+}
+
+/**
+ * @brief Borrows a constant or lazy singleton from the locator.
+ *
+ * The reference is cached per thread until the services generation changes,
+ * so repeated calls take no lock and touch no reference count. Transient
+ * services and containers that do not support borrowing yield an empty
+ * reference; use getService() for those.
+ * @tparam T The type of the service.
+ * @return A reference to the service, empty if it cannot be borrowed.
+ */
+template <class T>
+Borrowed<T> borrow() {
+    thread_local Borrowed<T> cached;
+    const std::uint64_t generation = servicesGeneration();
+    if (cached.generation() != generation) {
+        cached = detail::borrowService<T>(ContractId(), generation);
+    }
+
+    return cached;
+}
+
+/**
+ * @brief Borrows a constant or lazy singleton with an interned contract from the locator.
+ * @tparam T The type of the service.
+ * @param contract The interned contract for the service, see internContract().
+ * @return A reference to the service, empty if it cannot be borrowed.
+ */
+template <class T>
+Borrowed<T> borrow(ContractId contract) {
+    thread_local std::vector<Borrowed<T>> cache;
+    const std::uint64_t generation = servicesGeneration();
+    if (contract.value() >= cache.size()) {
+        cache.resize(contract.value() + 1);
+    }
+
+    Borrowed<T> &cached = cache[contract.value()];
+    if (cached.generation() != generation) {
+        cached = detail::borrowService<T>(contract, generation);
+    }
+
+    return cached;
+}
 }
 #endif //LOCATOR_H
\ No newline at end of file
@@ -0,0 +1,23 @@
+/**
+ * @file registration-batch.cpp
+ * @brief Implements batches of registrations applied to the container in one pass.
+ */
+
+#include "registration-batch.h"
+#include "container-manager.h"
+
+namespace PureIOC {
+std::size_t RegistrationBatch::commit() {
+    std::vector<ServiceRegistration> registrations;
+    registrations.swap(_registrations);
+
+    return currentContainer()->registerBatch(std::move(registrations));
+}
+
+bool RegistrationBatch::commitAll() {
+    std::vector<ServiceRegistration> registrations;
+    registrations.swap(_registrations);
+
+    return currentContainer()->registerAll(std::move(registrations));
+}
+}
@@ -0,0 +1,219 @@
+/**
+ * @file registration-batch.h
+ * @brief This file contains batches of registrations applied to the container in one pass.
+ */
+
+#ifndef REGISTRATION_BATCH_H
+#define REGISTRATION_BATCH_H
+#pragma once
+#include <any>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "locator-mutable.h"
+#include "service-pool.h"
+#include "services-interface.h"
+
+namespace PureIOC {
+/**
+ * @brief Collects registrations and applies them to the container at once.
+ *
+ * Registering many services one by one takes and releases the container locks
+ * and invalidates cached resolutions once per service. A batch builds every
+ * registration up front and hands them to the container in a single call, so
+ * the default container applies the whole batch under one acquisition of its
+ * locks, grows its tables once, invalidates cached resolutions once, and
+ * reports the services that were already registered in a single warning.
+ *
+ * A batch is not synchronized; build it from one thread.
+ */
+class RegistrationBatch {
+private:
+    std::vector<ServiceRegistration> _registrations;
+
+    template <class T>
+    RegistrationBatch &add(std::optional<std::string> contract, ServiceLifetime lifetime, ServiceFactory factory, std::any instance) {
+        _registrations.push_back(ServiceRegistration{std::type_index(typeid(T)), std::move(contract), lifetime, std::move(factory), std::move(instance), nullptr});
+        return *this;
+    }
+
+public:
+    /**
+     * @brief Reserves room for registrations.
+     * @param count The number of registrations about to be added.
+     * @return The batch.
+     */
+    RegistrationBatch &reserve(std::size_t count) {
+        _registrations.reserve(count);
+        return *this;
+    }
+
+    /**
+     * @brief Gets the number of registrations collected.
+     * @return The number of registrations.
+     */
+    std::size_t size() const noexcept {
+        return _registrations.size();
+    }
+
+    /**
+     * @brief Adds a service.
+     * @tparam T The type of the service.
+     * @tparam RT The return type of the factory.
+     * @tparam F The type of the factory.
+     * @param factory The factory that creates the service.
+     * @return The batch.
+     */
+    template <class T, class RT = T, class F, std::enable_if_t<detail::isFactory<RT, F>, int> = 0>
+    RegistrationBatch &addService(F &&factory) {
+        return add<T>(std::nullopt, ServiceLifetime::Transient, detail::makeFactory<T, RT>(std::forward<F>(factory)), std::any());
+    }
+
+    /**
+     * @brief Adds a service with a contract.
+     * @tparam T The type of the service.
+     * @tparam RT The return type of the factory.
+     * @tparam F The type of the factory.
+     * @param contract The contract for the service.
+     * @param factory The factory that creates the service.
+     * @return The batch.
+     */
+    template <class T, class RT = T, class F, std::enable_if_t<detail::isFactory<RT, F>, int> = 0>
+    RegistrationBatch &addService(const std::string &contract, F &&factory) {
+        return add<T>(contract, ServiceLifetime::Transient, detail::makeFactory<T, RT>(std::forward<F>(factory)), std::any());
+    }
+
+    /**
+     * @brief Adds a lazy singleton.
+     * @tparam T The type of the service.
+     * @tparam RT The return type of the factory.
+     * @tparam F The type of the factory.
+     * @param factory The factory that creates the service.
+     * @return The batch.
+     */
+    template <class T, class RT = T, class F, std::enable_if_t<detail::isFactory<RT, F>, int> = 0>
+    RegistrationBatch &addLazySingleton(F &&factory) {
+        return add<T>(std::nullopt, ServiceLifetime::LazySingleton, detail::makeFactory<T, RT>(std::forward<F>(factory)), std::any());
+    }
+
+    /**
+     * @brief Adds a lazy singleton with a contract.
+     * @tparam T The type of the service.
+     * @tparam RT The return type of the factory.
+     * @tparam F The type of the factory.
+     * @param contract The contract for the service.
+     * @param factory The factory that creates the service.
+     * @return The batch.
+     */
+    template <class T, class RT = T, class F, std::enable_if_t<detail::isFactory<RT, F>, int> = 0>
+    RegistrationBatch &addLazySingleton(const std::string &contract, F &&factory) {
+        return add<T>(contract, ServiceLifetime::LazySingleton, detail::makeFactory<T, RT>(std::forward<F>(factory)), std::any());
+    }
+
+    /**
+     * @brief Adds a constant.
+     * @tparam T The type of the service.
+     * @tparam RT The type of the service instance.
+     * @param service The service instance.
+     * @return The batch.
+     */
+    template <class T, class RT = T>
+    RegistrationBatch &addConstant(std::shared_ptr<RT> service) {
+        static_assert(std::is_convertible_v<RT *, T *>, "RT must be convertible to T");
+        return add<T>(std::nullopt, ServiceLifetime::Constant, nullptr, std::any(std::shared_ptr<T>(std::move(service))));
+    }
+
+    /**
+     * @brief Adds a constant with a contract.
+     * @tparam T The type of the service.
+     * @tparam RT The type of the service instance.
+     * @param contract The contract for the service.
+     * @param service The service instance.
+     * @return The batch.
+     */
+    template <class T, class RT = T>
+    RegistrationBatch &addConstant(const std::string &contract, std::shared_ptr<RT> service) {
+        static_assert(std::is_convertible_v<RT *, T *>, "RT must be convertible to T");
+        return add<T>(contract, ServiceLifetime::Constant, nullptr, std::any(std::shared_ptr<T>(std::move(service))));
+    }
+
+    /**
+     * @brief Adds a scoped service.
+     * @tparam T The type of the service.
+     * @tparam RT The return type of the factory.
+     * @tparam F The type of the factory.
+     * @param factory The factory, called with the scope that resolves the service.
+     * @return The batch.
+     */
+    template <class T, class RT = T, class F, std::enable_if_t<detail::isScopedFactory<RT, F>, int> = 0>
+    RegistrationBatch &addScoped(F &&factory) {
+        add<T>(std::nullopt, ServiceLifetime::Scoped, nullptr, std::any());
+        _registrations.back().scopedFactory = detail::makeScopedFactory<T, RT>(std::forward<F>(factory));
+        return *this;
+    }
+
+    /**
+     * @brief Adds a scoped service with a contract.
+     * @tparam T The type of the service.
+     * @tparam RT The return type of the factory.
+     * @tparam F The type of the factory.
+     * @param contract The contract for the service.
+     * @param factory The factory, called with the scope that resolves the service.
+     * @return The batch.
+     */
+    template <class T, class RT = T, class F, std::enable_if_t<detail::isScopedFactory<RT, F>, int> = 0>
+    RegistrationBatch &addScoped(const std::string &contract, F &&factory) {
+        add<T>(contract, ServiceLifetime::Scoped, nullptr, std::any());
+        _registrations.back().scopedFactory = detail::makeScopedFactory<T, RT>(std::forward<F>(factory));
+        return *this;
+    }
+
+    /**
+     * @brief Adds a pooled service.
+     * @tparam T The type of the service.
+     * @param pool The pool the service is taken from.
+     * @return The batch.
+     */
+    template <class T>
+    RegistrationBatch &addPooled(std::shared_ptr<ServicePool<T>> pool) {
+        return add<T>(std::nullopt, ServiceLifetime::Pooled, [pool = std::move(pool)]() -> std::any { return std::any(pool->acquire()); }, std::any());
+    }
+
+    /**
+     * @brief Adds a pooled service with a contract.
+     * @tparam T The type of the service.
+     * @param contract The contract for the service.
+     * @param pool The pool the service is taken from.
+     * @return The batch.
+     */
+    template <class T>
+    RegistrationBatch &addPooled(const std::string &contract, std::shared_ptr<ServicePool<T>> pool) {
+        return add<T>(contract, ServiceLifetime::Pooled, [pool = std::move(pool)]() -> std::any { return std::any(pool->acquire()); }, std::any());
+    }
+
+    /**
+     * @brief Applies the registrations to the current container and empties the batch.
+     * @return The number of services registered; services already registered are skipped.
+     */
+    std::size_t commit();
+
+    /**
+     * @brief Applies the registrations to the current container, all of them or none, and empties the batch.
+     *
+     * The default container rejects the whole batch if any of its services is
+     * already registered, under the same single acquisition of its locks, so
+     * no thread ever sees part of it.
+     * @return True if every service was registered, false if none was.
+     */
+    bool commitAll();
+};
+}
+#endif // REGISTRATION_BATCH_H
@@ -0,0 +1,44 @@
+/**
+ * @file scope.cpp
+ * @brief Implements scopes for resolving per-request services.
+ */
+
+#include "scope.h"
+#include "locator.h"
+#include "service-entry.h"
+
+namespace PureIOC {
+Scope::Scope()
+    : _arena(_buffer, sizeof(_buffer)), _instances(&_arena) {}
+
+Scope::~Scope() {
+    while (!_instances.empty()) {
+        _instances.pop_back();
+    }
+}
+
+Scope::Resolution Scope::resolve(std::size_t slot, const std::type_index &type, ContractId contract) {
+    for (const Instance &instance : _instances) {
+        if (instance.slot == slot && instance.contract == contract) {
+            return Resolution{instance.service, std::nullopt};
+        }
+    }
+
+    std::shared_ptr<ServiceEntry> entry = getEntry(slot, type, contract);
+    if (!entry) {
+        return Resolution{nullptr, ::PureIOC::getService(slot, type, contract)};
+    }
+
+    if (entry->lifetime() != ServiceLifetime::Scoped) {
+        std::any service = entry->resolve();
+        return Resolution{nullptr, service.has_value() ? std::optional<std::any>(std::move(service)) : std::nullopt};
+    }
+
+    std::shared_ptr<void> service = entry->create(*this);
+    if (service) {
+        _instances.push_back(Instance{slot, contract, service});
+    }
+
+    return Resolution{std::move(service), std::nullopt};
+}
+}
@@ -0,0 +1,120 @@
+/**
+ * @file scope.h
+ * @brief This file contains scopes for resolving per-request services.
+ */
+
+#ifndef SCOPE_H
+#define SCOPE_H
+#pragma once
+#include <any>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "contract-id.h"
+#include "service-slot.h"
+
+namespace PureIOC {
+/**
+ * @brief A short-lived scope, such as a request, that owns its scoped services.
+ *
+ * Services registered with registerScoped() are created once per scope, on
+ * first resolution, and released when the scope ends. Scoped factories can
+ * allocate their instances with make(), which places them in a monotonic
+ * arena owned by the scope: nothing is freed individually, and the arena
+ * starts in an inline buffer, so a scope that stays within it performs no
+ * heap allocation at all. Other services resolve as they would through the
+ * locator.
+ *
+ * Scoped instances must not outlive their scope. A scope is not
+ * synchronized; use it from one thread at a time.
+ */
+class Scope {
+public:
+    /**
+     * @brief The size of the inline buffer the arena starts in.
+     */
+    static constexpr std::size_t InlineSize = 1024;
+
+private:
+    /**
+     * @brief A scoped instance created by this scope.
+     */
+    struct Instance {
+        std::size_t slot;
+        ContractId contract;
+        std::shared_ptr<void> service;
+    };
+
+    /**
+     * @brief The result of resolving a service through the scope.
+     */
+    struct Resolution {
+        std::shared_ptr<void> scoped;    ///< The instance of a scoped service.
+        std::optional<std::any> service; ///< Any other service, as resolved by the container.
+    };
+
+    alignas(std::max_align_t) std::byte _buffer[InlineSize];
+    std::pmr::monotonic_buffer_resource _arena;
+    std::pmr::vector<Instance> _instances;
+
+    Resolution resolve(std::size_t slot, const std::type_index &type, ContractId contract);
+
+public:
+    /**
+     * @brief Constructs an empty scope.
+     */
+    Scope();
+    /**
+     * @brief Releases the scoped instances, most recently created first, then the arena.
+     */
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+    Scope(Scope &&) = delete;
+    Scope &operator=(Scope &&) = delete;
+
+    /**
+     * @brief Gets the arena of the scope.
+     * @return The memory resource backing make().
+     */
+    std::pmr::memory_resource *resource() noexcept {
+        return &_arena;
+    }
+
+    /**
+     * @brief Creates an object in the arena of the scope.
+     * @tparam U The type of the object.
+     * @tparam Args The types of the constructor arguments.
+     * @param args The constructor arguments.
+     * @return A shared pointer to the object, whose control block is in the arena as well.
+     */
+    template <class U, class... Args>
+    std::shared_ptr<U> make(Args &&...args) {
+        return std::allocate_shared<U>(std::pmr::polymorphic_allocator<U>(&_arena), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Gets a service through the scope.
+     * @tparam T The type of the service.
+     * @param contract The interned contract for the service, see internContract().
+     * @return A shared pointer to the service, or nullptr if not found.
+     */
+    template <class T>
+    std::shared_ptr<T> getService(ContractId contract = ContractId()) {
+        Resolution resolution = resolve(typeSlot<T>(), std::type_index(typeid(T)), contract);
+        if (resolution.scoped) {
+            return std::static_pointer_cast<T>(std::move(resolution.scoped));
+        }
+
+        return resolution.service ? std::any_cast<std::shared_ptr<T>>(*resolution.service) : nullptr;
+    }
+};
+}
+#endif // SCOPE_H
@@ -0,0 +1,48 @@
+/**
+ * @file service-entry.cpp
+ * @brief Implements the registration entry shared by containers and service handles.
+ */
+
+#include "service-entry.h"
+
+namespace PureIOC {
+ServiceEntry::ServiceEntry(ServiceLifetime lifetime, ServiceFactory factory, std::any instance)
+    : _lifetime(lifetime), _factory(std::move(factory)), _instance(std::move(instance)) {
+    if (_lifetime == ServiceLifetime::Constant) {
+        _published.store(&_instance, std::memory_order_relaxed);
+    }
+}
+
+ServiceEntry::ServiceEntry(std::function<std::shared_ptr<void>(Scope &)> factory)
+    : _lifetime(ServiceLifetime::Scoped), _scopedFactory(std::move(factory)) {}
+
+const std::any *ServiceEntry::borrow() {
+    if (const std::any *ready = peek()) {
+        return ready;
+    }
+
+    if (_lifetime == ServiceLifetime::Transient || _lifetime == ServiceLifetime::Scoped || _lifetime == ServiceLifetime::Pooled) {
+        return nullptr;
+    }
+
+    std::call_once(_once, [this] {
+        _instance = _factory();
+        _published.store(&_instance, std::memory_order_release);
+    });
+
+    return &_instance;
+}
+
+std::any ServiceEntry::resolve() {
+    if (_lifetime == ServiceLifetime::Scoped) {
+        return std::any();
+    }
+
+    const std::any *shared = borrow();
+    return shared ? *shared : _factory();
+}
+
+std::shared_ptr<void> ServiceEntry::create(Scope &scope) const {
+    return _scopedFactory ? _scopedFactory(scope) : nullptr;
+}
+}
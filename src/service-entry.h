@@ -0,0 +1,92 @@
+/**
+ * @file service-entry.h
+ * @brief This file contains the registration entry shared by containers and service handles.
+ */
+
+#ifndef SERVICE_ENTRY_H
+#define SERVICE_ENTRY_H
+#pragma once
+#include <any>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "service-factory.h"
+#include "services-interface.h"
+
+namespace PureIOC {
+/**
+ * @brief A registration: its lifetime, its factory, and its instance.
+ *
+ * Entries are shared by reference count, so a resolution can drop the
+ * container lock as soon as it holds the entry, and a ServiceHandle can keep
+ * resolving through the entry without going back to the container. Only the
+ * instance of a lazy singleton is written after registration, once, under its
+ * once flag; it is then published through an atomic pointer so later
+ * resolutions need a single acquire load instead of going through
+ * std::call_once.
+ */
+class ServiceEntry final {
+private:
+    ServiceLifetime _lifetime;
+    ServiceFactory _factory;            ///< The factory of a transient, lazy singleton or pooled service.
+    std::function<std::shared_ptr<void>(Scope &)> _scopedFactory; ///< The factory of a scoped service.
+    std::any _instance;                 ///< The constant, or the lazy singleton once constructed.
+    std::once_flag _once;               ///< Guards the construction of a lazy singleton.
+    std::atomic<const std::any *> _published{nullptr}; ///< Points to the instance once it is ready.
+
+public:
+    /**
+     * @brief Constructs an entry.
+     * @param lifetime The lifetime of the service.
+     * @param factory The factory of a transient service or lazy singleton, empty for a constant.
+     * @param instance The instance of a constant, empty otherwise.
+     */
+    ServiceEntry(ServiceLifetime lifetime, ServiceFactory factory, std::any instance);
+    /**
+     * @brief Constructs the entry of a scoped service.
+     * @param factory The factory, called with the scope that resolves the service.
+     */
+    explicit ServiceEntry(std::function<std::shared_ptr<void>(Scope &)> factory);
+
+    ServiceEntry(const ServiceEntry &) = delete;
+    ServiceEntry &operator=(const ServiceEntry &) = delete;
+
+    /**
+     * @brief Gets the lifetime of the service.
+     * @return The lifetime.
+     */
+    ServiceLifetime lifetime() const noexcept {
+        return _lifetime;
+    }
+
+    /**
+     * @brief Gets the instance if it is ready, without constructing it.
+     * @return The constant or the constructed lazy singleton, or nullptr.
+     */
+    const std::any *peek() const noexcept {
+        return _published.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Gets the shared instance, constructing a lazy singleton if needed.
+     * @return The constant or the lazy singleton, or nullptr for a transient, scoped or pooled service.
+     */
+    const std::any *borrow();
+
+    /**
+     * @brief Resolves the service held by the entry.
+     * @return The constant, the lazy singleton, or a new transient or pooled instance; empty for a scoped service.
+     */
+    std::any resolve();
+
+    /**
+     * @brief Creates the instance of a scoped service for a scope.
+     * @param scope The scope that resolves the service.
+     * @return The instance, or nullptr if the service is not scoped.
+     */
+    std::shared_ptr<void> create(Scope &scope) const;
+};
+}
+#endif // SERVICE_ENTRY_H
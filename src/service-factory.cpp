@@ -0,0 +1,22 @@
+/**
+ * @file service-factory.cpp
+ * @brief Implements the heap fallback counter of service factories.
+ */
+
+#include "service-factory.h"
+
+#include <atomic>
+
+namespace PureIOC {
+namespace {
+    std::atomic<std::uint64_t> g_heap_fallbacks{0}; ///< The number of factories whose callable fell back to the heap.
+}
+
+void detail::countFactoryHeapFallback() noexcept {
+    g_heap_fallbacks.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint64_t ServiceFactory::heapFallbacks() noexcept {
+    return g_heap_fallbacks.load(std::memory_order_relaxed);
+}
+}
@@ -0,0 +1,202 @@
+/**
+ * @file service-factory.h
+ * @brief This file contains the move-only factory type stored by containers.
+ */
+
+#ifndef SERVICE_FACTORY_H
+#define SERVICE_FACTORY_H
+#pragma once
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace PureIOC {
+namespace detail {
+/**
+ * @brief Counts a factory that did not fit in the inline storage of a ServiceFactory.
+ */
+void countFactoryHeapFallback() noexcept;
+}
+
+/**
+ * @brief A move-only factory that stores its callable inline.
+ *
+ * Callables of up to InlineSize bytes that can be moved without throwing are
+ * stored in the factory itself, so creating, moving and calling the factory
+ * never touches the heap, and the registry keeps its factories next to its
+ * entries. Larger callables fall back to a heap allocation, counted by
+ * heapFallbacks(). Unlike std::function, the callable does not have to be
+ * copyable.
+ *
+ * The callable is called in place, through a const reference, by every
+ * thread that resolves the service, so it must be safe to call
+ * concurrently; mutable lambdas are rejected. A std::function, which may
+ * wrap a mutable callable, is copied for each call instead, as it was
+ * before factories were stored inline.
+ */
+class ServiceFactory {
+public:
+    /**
+     * @brief The number of bytes of callable stored inline.
+     */
+    static constexpr std::size_t InlineSize = 48;
+
+private:
+    struct Operations {
+        std::any (*invoke)(const void *storage);
+        void (*move)(void *target, void *source) noexcept;
+        void (*destroy)(void *storage) noexcept;
+        bool inlined;
+    };
+
+    template <class F>
+    static constexpr bool fitsInline = sizeof(F) <= InlineSize && alignof(F) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<F>;
+
+    template <class F>
+    static const Operations *inlineOperations() noexcept {
+        static constexpr Operations operations{
+            [](const void *storage) -> std::any { return (*std::launder(static_cast<const F *>(storage)))(); },
+            [](void *target, void *source) noexcept {
+                F *callable = std::launder(static_cast<F *>(source));
+                ::new (target) F(std::move(*callable));
+                callable->~F();
+            },
+            [](void *storage) noexcept { std::launder(static_cast<F *>(storage))->~F(); },
+            true,
+        };
+        return &operations;
+    }
+
+    template <class F>
+    static const Operations *heapOperations() noexcept {
+        static constexpr Operations operations{
+            [](const void *storage) -> std::any { return static_cast<const F &>(**static_cast<F *const *>(storage))(); },
+            [](void *target, void *source) noexcept { *static_cast<F **>(target) = *static_cast<F **>(source); },
+            [](void *storage) noexcept { delete *static_cast<F **>(storage); },
+            false,
+        };
+        return &operations;
+    }
+
+    alignas(std::max_align_t) std::byte _storage[InlineSize];
+    const Operations *_operations = nullptr;
+
+    template <class F>
+    void emplace(F &&callable) {
+        using C = std::decay_t<F>;
+        if constexpr (fitsInline<C>) {
+            ::new (static_cast<void *>(_storage)) C(std::forward<F>(callable));
+            _operations = inlineOperations<C>();
+        } else {
+            *reinterpret_cast<C **>(_storage) = new C(std::forward<F>(callable));
+            _operations = heapOperations<C>();
+            detail::countFactoryHeapFallback();
+        }
+    }
+
+    void reset() noexcept {
+        if (_operations) {
+            _operations->destroy(_storage);
+            _operations = nullptr;
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs an empty factory.
+     */
+    ServiceFactory() noexcept = default;
+    /**
+     * @brief Constructs an empty factory.
+     */
+    ServiceFactory(std::nullptr_t) noexcept {}
+
+    /**
+     * @brief Constructs a factory from a callable that returns std::any.
+     *
+     * The callable must be callable as const. An empty std::function yields
+     * an empty factory.
+     * @tparam F The type of the callable.
+     * @param callable The callable.
+     */
+    template <class F, class C = std::decay_t<F>,
+        std::enable_if_t<!std::is_same_v<C, ServiceFactory> && std::is_invocable_r_v<std::any, const C &>, int> = 0>
+    ServiceFactory(F &&callable) {
+        if constexpr (std::is_same_v<C, std::function<std::any()>>) {
+            if (callable) {
+                emplace([function = std::forward<F>(callable)]() -> std::any { return std::function<std::any()>(function)(); });
+            }
+        } else {
+            emplace(std::forward<F>(callable));
+        }
+    }
+
+    ServiceFactory(ServiceFactory &&other) noexcept
+        : _operations(other._operations) {
+        if (_operations) {
+            _operations->move(_storage, other._storage);
+            other._operations = nullptr;
+        }
+    }
+
+    ServiceFactory &operator=(ServiceFactory &&other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other._operations) {
+                other._operations->move(_storage, other._storage);
+                _operations = other._operations;
+                other._operations = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    ServiceFactory(const ServiceFactory &) = delete;
+    ServiceFactory &operator=(const ServiceFactory &) = delete;
+
+    ~ServiceFactory() {
+        reset();
+    }
+
+    /**
+     * @brief Creates a service.
+     * @return The service.
+     * @throws std::bad_function_call If the factory is empty, as std::function does.
+     */
+    std::any operator()() const {
+        if (!_operations) {
+            throw std::bad_function_call();
+        }
+
+        return _operations->invoke(_storage);
+    }
+
+    /**
+     * @brief Checks whether the factory holds a callable.
+     * @return True if the factory is not empty.
+     */
+    explicit operator bool() const noexcept {
+        return _operations != nullptr;
+    }
+
+    /**
+     * @brief Checks whether the callable is stored inline.
+     * @return True if the factory is empty or its callable did not need the heap.
+     */
+    bool isInline() const noexcept {
+        return !_operations || _operations->inlined;
+    }
+
+    /**
+     * @brief Gets the number of factories whose callable fell back to the heap.
+     * @return The number of heap fallbacks since the program started.
+     */
+    static std::uint64_t heapFallbacks() noexcept;
+};
+}
+#endif // SERVICE_FACTORY_H
@@ -0,0 +1,136 @@
+/**
+ * @file service-handle.h
+ * @brief This file contains pre-resolved handles for services resolved repeatedly.
+ */
+
+#ifndef SERVICE_HANDLE_H
+#define SERVICE_HANDLE_H
+#pragma once
+#include <any>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <typeindex>
+#include <typeinfo>
+
+#include "container-manager.h"
+#include "contract-id.h"
+#include "dependency-recorder.h"
+#include "locator.h"
+#include "service-entry.h"
+#include "service-slot.h"
+
+namespace PureIOC {
+namespace detail {
+/**
+ * @brief Resolves a service through its registration entry.
+ * @tparam T The type of the service.
+ * @param entry The entry.
+ * @return A shared pointer to the service, or nullptr for a scoped service.
+ */
+template <class T>
+std::shared_ptr<T> resolveEntry(ServiceEntry &entry) {
+    if (const std::any *ready = entry.peek()) {
+        return std::any_cast<std::shared_ptr<T>>(*ready);
+    }
+
+    std::any service = entry.resolve();
+    return service.has_value() ? std::any_cast<std::shared_ptr<T>>(service) : nullptr;
+}
+}
+
+/**
+ * @brief A handle that resolves a service through its registration entry.
+ *
+ * The handle looks the entry up once and keeps it, so get() resolves a
+ * constant or a constructed lazy singleton with a couple of atomic loads and
+ * a transient service with a direct call to its factory. A bound entry is
+ * validated with a single load of a counter that invalidateServices() and
+ * every change to a default container advance, so the handle follows
+ * unregistrations, re-registrations and container replacements. Containers
+ * that expose no entries are resolved through getService(). A service found
+ * by neither is recorded as missing, and get() returns nullptr without
+ * asking the container again until the services generation changes. While
+ * a DependencyRecorder is alive, the entry is not kept, so that every
+ * resolution goes through the container and is recorded.
+ *
+ * A handle is not synchronized; give each thread its own copy.
+ * @tparam T The type of the service.
+ */
+template <class T>
+class ServiceHandle {
+private:
+    ContractId _contract;
+    std::uint64_t _changes = 0;    ///< The value of detail::servicesChanges the entry was looked up at.
+    std::uint64_t _generation = 0; ///< The services generation the service was found missing in.
+    std::shared_ptr<ServiceEntry> _entry;
+    bool _missing = false; ///< Whether the service was not found in the current generation.
+
+    std::shared_ptr<T> lookup() {
+        const std::uint64_t changes = detail::servicesChanges.load(std::memory_order_acquire);
+        const std::uint64_t generation = servicesGeneration();
+        if (_entry || _changes != changes || _generation != generation) {
+            _entry = getEntry(typeSlot<T>(), std::type_index(typeid(T)), _contract);
+            _changes = changes;
+            _generation = generation;
+            _missing = false;
+        }
+
+        std::shared_ptr<ServiceEntry> entry = detail::liveRecorders.load(std::memory_order_relaxed) ? std::move(_entry) : _entry;
+        if (entry) {
+            return detail::resolveEntry<T>(*entry);
+        }
+        if (_missing) {
+            return nullptr;
+        }
+
+        std::shared_ptr<T> service = getService<T>(_contract);
+        _missing = !service;
+        return service;
+    }
+
+public:
+    /**
+     * @brief Constructs a handle to the service of type T.
+     * @param contract The interned contract for the service, or the "no contract" id.
+     */
+    explicit ServiceHandle(ContractId contract = ContractId()) noexcept
+        : _contract(contract) {}
+
+    /**
+     * @brief Gets the contract of the handle.
+     * @return The interned contract.
+     */
+    ContractId contract() const noexcept {
+        return _contract;
+    }
+
+    /**
+     * @brief Resolves the service.
+     * @return A shared pointer to the service, or nullptr if not found.
+     */
+    std::shared_ptr<T> get() {
+        if (_entry && _changes == detail::servicesChanges.load(std::memory_order_acquire)) {
+            return detail::resolveEntry<T>(*_entry);
+        }
+
+        return lookup();
+    }
+
+    std::shared_ptr<T> operator()() {
+        return get();
+    }
+};
+
+/**
+ * @brief Gets a handle to a service.
+ * @tparam T The type of the service.
+ * @param contract The interned contract for the service, see internContract().
+ * @return The handle; the service is resolved on the first call to get().
+ */
+template <class T>
+ServiceHandle<T> getServiceHandle(ContractId contract = ContractId()) {
+    return ServiceHandle<T>(contract);
+}
+}
+#endif // SERVICE_HANDLE_H
@@ -0,0 +1,220 @@
+/**
+ * @file service-pool.cpp
+ * @brief Implements the free lists of object pools.
+ */
+
+#include <algorithm>
+
+#include "service-pool.h"
+
+namespace PureIOC::detail {
+namespace {
+/**
+ * @brief Whether the pool caches of the calling thread were destroyed, at thread exit.
+ *
+ * Trivially destructible, so it can still be read by pooled services
+ * released by thread-local objects destroyed after the caches.
+ */
+thread_local bool t_caches_destroyed = false;
+}
+
+/**
+ * @brief The pool caches of a thread.
+ */
+struct PoolCore::ThreadCaches {
+    std::vector<ThreadCache> list;
+
+    ~ThreadCaches() {
+        t_caches_destroyed = true;
+    }
+
+    /**
+     * @brief Gets the pool caches of the calling thread.
+     * @return The caches, or nullptr once they were destroyed.
+     */
+    static ThreadCaches *current() {
+        if (t_caches_destroyed) {
+            return nullptr;
+        }
+
+        thread_local ThreadCaches caches;
+        return &caches;
+    }
+};
+
+/**
+ * @brief The idle objects a thread keeps for one pool.
+ */
+struct PoolCore::ThreadCache {
+    const PoolCore *owner = nullptr;
+    std::weak_ptr<PoolCore> core;
+    void (*destroy)(void *) = nullptr;
+    std::vector<void *> objects;
+
+    ThreadCache() = default;
+    ThreadCache(ThreadCache &&) = default;
+    ThreadCache &operator=(ThreadCache &&) = default;
+
+    ~ThreadCache() {
+        flush();
+    }
+
+    /**
+     * @brief Hands the objects back to their pool, or destroys them if the pool is gone.
+     */
+    void flush() {
+        if (objects.empty()) {
+            return;
+        }
+
+        if (std::shared_ptr<PoolCore> alive = core.lock()) {
+            alive->reclaim(objects);
+        }
+        for (void *object : objects) {
+            destroy(object);
+        }
+        objects.clear();
+    }
+};
+
+PoolCore::PoolCore(const PoolOptions &options, void (*destroy)(void *))
+    : _options(options), _destroy(destroy) {}
+
+/**
+ * @brief Destroys the idle objects shared between threads and cached by the calling thread.
+ *
+ * Objects cached by other threads are destroyed when those threads exit.
+ */
+PoolCore::~PoolCore() {
+    for (void *object : _idle) {
+        _destroy(object);
+    }
+
+    if (ThreadCaches *caches = ThreadCaches::current()) {
+        for (ThreadCache &cache : caches->list) {
+            if (cache.owner == this) {
+                cache.core.reset();
+                cache.flush();
+            }
+        }
+    }
+}
+
+/**
+ * @brief Gets the cache of the calling thread for this pool.
+ *
+ * A cache left behind by a destroyed pool at the same address is flushed and
+ * taken over. Before a cache is added, those left behind by other destroyed
+ * pools are flushed and erased, so the caches of a thread that outlives many
+ * pools do not grow without bound.
+ * @return The cache, or nullptr once the caches of the thread were destroyed.
+ */
+PoolCore::ThreadCache *PoolCore::threadCache() {
+    ThreadCaches *caches = ThreadCaches::current();
+    if (!caches) {
+        return nullptr;
+    }
+
+    for (ThreadCache &cache : caches->list) {
+        if (cache.owner == this) {
+            if (cache.core.expired()) {
+                cache.flush();
+                cache.core = weak_from_this();
+                cache.destroy = _destroy;
+            }
+            return &cache;
+        }
+    }
+
+    auto expired = [](const ThreadCache &cache) {
+        return cache.core.expired();
+    };
+    for (ThreadCache &cache : caches->list) {
+        if (expired(cache)) {
+            cache.flush();
+        }
+    }
+    caches->list.erase(std::remove_if(caches->list.begin(), caches->list.end(), expired), caches->list.end());
+
+    ThreadCache &cache = caches->list.emplace_back();
+    cache.owner = this;
+    cache.core = weak_from_this();
+    cache.destroy = _destroy;
+    return &cache;
+}
+
+/**
+ * @brief Moves objects cached by an exiting thread into the shared list, as far as there is room.
+ * @param objects The objects; those left over must be destroyed by the caller.
+ */
+void PoolCore::reclaim(std::vector<void *> &objects) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    while (!objects.empty() && _idle.size() < _options.capacity) {
+        _idle.push_back(objects.back());
+        objects.pop_back();
+    }
+}
+
+void *PoolCore::acquire() {
+    ThreadCache *cache = threadCache();
+    if (cache && !cache->objects.empty()) {
+        void *object = cache->objects.back();
+        cache->objects.pop_back();
+        _hits.fetch_add(1, std::memory_order_relaxed);
+        return object;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_idle.empty()) {
+            void *object = _idle.back();
+            _idle.pop_back();
+            _hits.fetch_add(1, std::memory_order_relaxed);
+            return object;
+        }
+    }
+
+    _misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void PoolCore::release(void *object) noexcept {
+    try {
+        ThreadCache *cache = threadCache();
+        if (cache && cache->objects.size() < _options.threadCache) {
+            cache->objects.push_back(object);
+            _recycled.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_idle.size() < _options.capacity) {
+            _idle.push_back(object);
+            _recycled.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    } catch (...) {
+    }
+
+    discard(object);
+}
+
+void PoolCore::discard(void *object) noexcept {
+    _discarded.fetch_add(1, std::memory_order_relaxed);
+    _destroy(object);
+}
+
+PoolStats PoolCore::stats() const noexcept {
+    PoolStats stats;
+    stats.hits = _hits.load(std::memory_order_relaxed);
+    stats.misses = _misses.load(std::memory_order_relaxed);
+    stats.recycled = _recycled.load(std::memory_order_relaxed);
+    stats.discarded = _discarded.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::pmr::polymorphic_allocator<std::byte> poolAllocator() noexcept {
+    static std::pmr::synchronized_pool_resource *blocks = new std::pmr::synchronized_pool_resource();
+    return std::pmr::polymorphic_allocator<std::byte>(blocks);
+}
+}
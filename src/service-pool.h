@@ -0,0 +1,218 @@
+/**
+ * @file service-pool.h
+ * @brief This file contains object pools backing pooled services.
+ */
+
+#ifndef SERVICE_POOL_H
+#define SERVICE_POOL_H
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace PureIOC {
+/**
+ * @brief The bounds of a ServicePool.
+ */
+struct PoolOptions {
+    std::size_t capacity = 64;   ///< The number of idle objects the pool shares between threads.
+    std::size_t threadCache = 8; ///< The number of idle objects each thread keeps for itself.
+};
+
+/**
+ * @brief The counters of a ServicePool.
+ */
+struct PoolStats {
+    std::uint64_t hits = 0;      ///< Acquisitions served by a recycled object.
+    std::uint64_t misses = 0;    ///< Acquisitions that had to create an object.
+    std::uint64_t recycled = 0;  ///< Objects returned to the pool.
+    std::uint64_t discarded = 0; ///< Objects destroyed because the pool was full or their reset failed.
+
+    /**
+     * @brief Gets the share of acquisitions served by a recycled object.
+     * @return The hit rate, between 0 and 1; 0 before the first acquisition.
+     */
+    double hitRate() const noexcept {
+        const std::uint64_t total = hits + misses;
+        return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+    }
+};
+
+namespace detail {
+/**
+ * @brief The type-erased free lists of a ServicePool.
+ *
+ * Each thread keeps a small cache of idle objects per pool, so acquiring and
+ * recycling on one thread takes no lock; the pool shares a bounded list
+ * between threads for the rest. Objects cached by a thread go back to the
+ * pool when the thread exits, or are destroyed if the pool is gone by then.
+ */
+class PoolCore : public std::enable_shared_from_this<PoolCore> {
+private:
+    struct ThreadCache;
+    struct ThreadCaches;
+
+    const PoolOptions _options;
+    void (*const _destroy)(void *);
+    mutable std::mutex _mutex;
+    std::vector<void *> _idle; ///< The objects shared between threads; guarded by the mutex.
+    std::atomic<std::uint64_t> _hits{0};
+    std::atomic<std::uint64_t> _misses{0};
+    std::atomic<std::uint64_t> _recycled{0};
+    std::atomic<std::uint64_t> _discarded{0};
+
+    ThreadCache *threadCache();
+    void reclaim(std::vector<void *> &objects);
+
+public:
+    /**
+     * @brief Constructs empty free lists.
+     * @param options The bounds of the pool.
+     * @param destroy Destroys an object of the pool.
+     */
+    PoolCore(const PoolOptions &options, void (*destroy)(void *));
+    /**
+     * @brief Destroys the idle objects shared between threads.
+     */
+    ~PoolCore();
+
+    PoolCore(const PoolCore &) = delete;
+    PoolCore &operator=(const PoolCore &) = delete;
+
+    /**
+     * @brief Takes an idle object.
+     * @return The object, or nullptr if the pool has none and a new one must be created.
+     */
+    void *acquire();
+    /**
+     * @brief Returns an object that was reset to the pool, destroying it if the pool is full.
+     * @param object The object.
+     */
+    void release(void *object) noexcept;
+    /**
+     * @brief Destroys an object that cannot be recycled.
+     * @param object The object.
+     */
+    void discard(void *object) noexcept;
+    /**
+     * @brief Gets the counters of the pool.
+     * @return The counters.
+     */
+    PoolStats stats() const noexcept;
+};
+
+/**
+ * @brief Gets the allocator for the control blocks of pooled services.
+ *
+ * The control blocks are recycled by a synchronized pool resource that is
+ * never destroyed, so resolving a pooled service allocates nothing once the
+ * pool is warm, and a control block may be released on any thread at any
+ * time.
+ * @return The allocator.
+ */
+std::pmr::polymorphic_allocator<std::byte> poolAllocator() noexcept;
+
+/**
+ * @brief Destroys an object of a pool.
+ * @tparam T The type of the objects.
+ * @param object The object.
+ */
+template <class T>
+void destroyPooled(void *object) {
+    delete static_cast<T *>(object);
+}
+}
+
+/**
+ * @brief A bounded pool of reusable instances of a service.
+ *
+ * Pools back services registered with registerPooled(). acquire() hands out
+ * an idle instance when one is available and creates one otherwise; when the
+ * last shared pointer to it is released, the instance is reset with the reset
+ * hook and returned to the pool instead of being destroyed. Instances the pool
+ * has no room for are destroyed. The pool outlives its registration for as
+ * long as instances it handed out are alive.
+ * @tparam T The type of the service.
+ */
+template <class T>
+class ServicePool {
+private:
+    struct State {
+        std::function<std::unique_ptr<T>()> factory;
+        std::function<void(T &)> reset;
+        std::shared_ptr<detail::PoolCore> core;
+    };
+
+    /**
+     * @brief Returns an instance to its pool when its last shared pointer is released.
+     */
+    struct Recycler {
+        std::shared_ptr<State> state;
+
+        void operator()(T *object) const noexcept {
+            if (state->reset) {
+                try {
+                    state->reset(*object);
+                } catch (...) {
+                    state->core->discard(object);
+                    return;
+                }
+            }
+
+            state->core->release(object);
+        }
+    };
+
+    std::shared_ptr<State> _state;
+
+public:
+    /**
+     * @brief Constructs a pool of default-constructed instances.
+     * @param options The bounds of the pool.
+     */
+    explicit ServicePool(const PoolOptions &options = PoolOptions())
+        : ServicePool([] { return std::make_unique<T>(); }, nullptr, options) {}
+
+    /**
+     * @brief Constructs a pool.
+     * @param factory Creates an instance when the pool has none idle.
+     * @param reset Resets an instance before it is recycled; may be empty.
+     * @param options The bounds of the pool.
+     */
+    ServicePool(std::function<std::unique_ptr<T>()> factory, std::function<void(T &)> reset, const PoolOptions &options = PoolOptions())
+        : _state(std::make_shared<State>(State{std::move(factory), std::move(reset),
+              std::make_shared<detail::PoolCore>(options, &detail::destroyPooled<T>)})) {}
+
+    /**
+     * @brief Takes an instance from the pool, creating one if none is idle.
+     * @return A shared pointer that recycles the instance when it is released, or nullptr if the factory created none.
+     */
+    std::shared_ptr<T> acquire() {
+        T *object = static_cast<T *>(_state->core->acquire());
+        if (!object) {
+            object = _state->factory().release();
+            if (!object) {
+                return nullptr;
+            }
+        }
+
+        return std::shared_ptr<T>(object, Recycler{_state}, detail::poolAllocator());
+    }
+
+    /**
+     * @brief Gets the counters of the pool.
+     * @return The counters.
+     */
+    PoolStats stats() const noexcept {
+        return _state->core->stats();
+    }
+};
+}
+#endif // SERVICE_POOL_H
@@ -0,0 +1,32 @@
+/**
+ * @file service-slot.cpp
+ * @brief Implements the registry of service type slots.
+ */
+
+#include "service-slot.h"
+#include "internal/intern-table.h"
+
+namespace PureIOC {
+namespace {
+    /**
+     * @brief Gets the registry of service type slots.
+     *
+     * Lookups read the registry without locking, so resolving a type by
+     * std::type_index never contends with other readers once it has a slot.
+     * @return The registry.
+     */
+    internal::InternTable<std::type_index> &slots() {
+        static internal::InternTable<std::type_index> table;
+        return table;
+    }
+}
+
+std::size_t typeSlot(const std::type_index &type) {
+    return slots().intern(type);
+}
+
+std::type_index slotType(std::size_t slot) {
+    const std::type_index *type = slots().get(slot);
+    return type ? *type : std::type_index(typeid(void));
+}
+}
@@ -0,0 +1,45 @@
+/**
+ * @file service-slot.h
+ * @brief This file contains the dense slot identifiers assigned to service types.
+ */
+
+#ifndef SERVICE_SLOT_H
+#define SERVICE_SLOT_H
+#pragma once
+#include <cstddef>
+#include <typeindex>
+#include <typeinfo>
+
+namespace PureIOC {
+/**
+ * @brief Gets the slot assigned to a service type.
+ *
+ * Slots are small dense integers handed out on first use, starting at zero,
+ * so containers can keep uncontracted services in a flat array indexed by slot.
+ * Looking up a type that already has a slot takes no lock.
+ * @param type The type of the service.
+ * @return The slot of the type.
+ */
+std::size_t typeSlot(const std::type_index &type);
+
+/**
+ * @brief Gets the service type a slot was assigned to.
+ * @param slot The slot, as returned by typeSlot().
+ * @return The type, or typeid(void) if the slot was never assigned.
+ */
+std::type_index slotType(std::size_t slot);
+
+/**
+ * @brief Gets the slot assigned to a service type.
+ *
+ * The slot is looked up once per type and cached in a function-local static.
+ * @tparam T The type of the service.
+ * @return The slot of the type.
+ */
+template <class T>
+std::size_t typeSlot() {
+    static const std::size_t slot = typeSlot(std::type_index(typeid(T)));
+    return slot;
+}
+}
+#endif // SERVICE_SLOT_H
@@ -1,13 +1,74 @@
 #ifndef SERVICES_INTERFACE_H
 #define SERVICES_INTERFACE_H
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <typeindex>
 #include <functional>
 #include <any>
+#include <memory>
 #include <optional>
+#include <utility>
+#include <vector>
+
+#include "contract-id.h"
+#include "service-factory.h"
 
 namespace PureIOC {
+/**
+ * @brief The lifetime a service was registered with.
+ */
+enum class ServiceLifetime {
+    Transient,     ///< A new instance is created on every request.
+    LazySingleton, ///< A single instance is created on the first request.
+    Constant,      ///< A pre-existing instance is returned.
+    Scoped,        ///< A single instance is created per Scope.
+    Pooled         ///< An instance is taken from a pool on every request and recycled when released.
+};
+
+class Scope;
+class ServiceEntry;
+
+/**
+ * @brief A service requested by resolveAll().
+ */
+struct ServiceRequest {
+    std::size_t slot;     ///< The slot of the type, as returned by typeSlot().
+    std::type_index type; ///< The type of the service.
+    ContractId contract;  ///< The interned contract for the service.
+};
+
+/**
+ * @brief A registration entry listed by a container.
+ */
+struct RegisteredEntry {
+    std::size_t slot;                    ///< The slot of the type, as returned by typeSlot().
+    ContractId contract;                 ///< The interned contract of the service.
+    std::shared_ptr<ServiceEntry> entry; ///< The entry.
+};
+
+/**
+ * @brief A registration collected by a RegistrationBatch.
+ */
+struct ServiceRegistration {
+    std::type_index type;                ///< The type of the service.
+    std::optional<std::string> contract; ///< The contract of the service, if any.
+    ServiceLifetime lifetime;            ///< The lifetime of the service.
+    ServiceFactory factory;              ///< The factory of a transient, lazy singleton or pooled service.
+    std::any instance;                   ///< The instance of a constant.
+    std::function<std::shared_ptr<void>(Scope &)> scopedFactory; ///< The factory of a scoped service.
+};
+
+/**
+ * @brief A service named by IServices::unregisterAll().
+ */
+struct ServiceKey {
+    std::type_index type;                ///< The type of the service.
+    std::optional<std::string> contract; ///< The contract of the service, if any.
+};
+
 /**
  * @brief An interface for a service locator.
  */
@@ -18,6 +79,43 @@ protected:
      */
     IServices() = default;
 
+    /**
+     * @brief Wraps a move-only factory into a copyable std::function.
+     * @param factory The factory.
+     * @return The function, empty if the factory is empty.
+     */
+    static std::function<std::any()> wrapFactory(ServiceFactory factory) {
+        if (!factory) {
+            return nullptr;
+        }
+
+        return [shared = std::make_shared<ServiceFactory>(std::move(factory))]() { return (*shared)(); };
+    }
+
+    /**
+     * @brief Applies a single registration of a batch.
+     * @param registration The registration; its factory or instance is moved from.
+     * @return True if the service was registered, false otherwise.
+     */
+    bool registerOne(ServiceRegistration &registration) {
+        const std::type_index &type = registration.type;
+        switch (registration.lifetime) {
+        case ServiceLifetime::Transient:
+        case ServiceLifetime::LazySingleton:
+        case ServiceLifetime::Pooled:
+            return registration.contract ? registerFactory(type, *registration.contract, registration.lifetime, std::move(registration.factory))
+                                         : registerFactory(type, registration.lifetime, std::move(registration.factory));
+        case ServiceLifetime::Constant:
+            return registration.contract ? registerConstant(type, *registration.contract, std::move(registration.instance))
+                                         : registerConstant(type, std::move(registration.instance));
+        case ServiceLifetime::Scoped:
+            return registration.contract ? registerScoped(type, *registration.contract, std::move(registration.scopedFactory))
+                                         : registerScoped(type, std::move(registration.scopedFactory));
+        }
+
+        return false;
+    }
+
 public:
     /**
      * @brief Default destructor.
@@ -36,6 +134,161 @@ public:
      * @return An optional containing the service if found.
      */
     virtual std::optional<std::any> getService(const std::type_index &type, const std::string &contract) = 0;
+    /**
+     * @brief Gets a service of the specified type using its precomputed slot.
+     *
+     * Containers that index services by slot can override this to skip hashing
+     * the type. The default implementation ignores the slot.
+     * @param slot The slot of the type, as returned by typeSlot().
+     * @param type The type of the service to get.
+     * @return An optional containing the service if found.
+     */
+    virtual std::optional<std::any> getService(std::size_t slot, const std::type_index &type) {
+        (void)slot;
+        return getService(type);
+    }
+    /**
+     * @brief Gets a service using the precomputed slot of its type and a contract view.
+     *
+     * Containers can override this to look the contract up without
+     * materializing a std::string. The default implementation copies the
+     * contract and forwards to getService(type, contract).
+     * @param slot The slot of the type, as returned by typeSlot().
+     * @param type The type of the service to get.
+     * @param contract The contract for the service.
+     * @return An optional containing the service if found.
+     */
+    virtual std::optional<std::any> getService(std::size_t slot, const std::type_index &type, std::string_view contract) {
+        (void)slot;
+        return getService(type, std::string(contract));
+    }
+    /**
+     * @brief Gets a service using the precomputed slot of its type and an interned contract.
+     *
+     * Containers that key services by contract id can override this to skip
+     * copying and hashing the contract. The default implementation resolves
+     * the contract back to its string; the "no contract" id resolves the
+     * uncontracted service.
+     * @param slot The slot of the type, as returned by typeSlot().
+     * @param type The type of the service to get.
+     * @param contract The interned contract for the service.
+     * @return An optional containing the service if found.
+     */
+    virtual std::optional<std::any> getService(std::size_t slot, const std::type_index &type, ContractId contract) {
+        return contract ? getService(type, contractName(contract)) : getService(slot, type);
+    }
+
+    /**
+     * @brief Gets several services at once.
+     *
+     * Containers can override this to look all the services up in one
+     * consistent view of their registrations. The default implementation
+     * gets the services one by one.
+     * @param requests The services to get.
+     * @param results Receives an optional containing each service if found, in the order of the requests.
+     * @param count The number of requests.
+     */
+    virtual void getServices(const ServiceRequest *requests, std::optional<std::any> *results, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            results[i] = getService(requests[i].slot, requests[i].type, requests[i].contract);
+        }
+    }
+
+    /**
+     * @brief Gets the generation of the registrations visible through the container.
+     *
+     * Containers that track their registrations return a value that changes
+     * whenever a service visible through them, including one inherited from a
+     * parent, is registered or unregistered. Resolutions cached from the
+     * container are kept until it changes, so a registration only invalidates
+     * the caches of the container that owns it and of its children. Child
+     * containers cache what getEntry() returns, misses included, until the
+     * generation changes, so containers that report one must expose their
+     * entries. The default implementation returns zero; such containers must
+     * call invalidateServices() whenever their registrations change.
+     * @return The generation of the container.
+     */
+    virtual std::uint64_t generation() noexcept {
+        return 0;
+    }
+
+    /**
+     * @brief Gets the lifetime a service was registered with.
+     *
+     * Used to decide whether a resolved service may be cached. Containers that
+     * report a lifetime must report a generation() too, or call
+     * invalidateServices() whenever their registrations change. The default implementation reports no lifetime,
+     * which disables caching.
+     * @param type The type of the service.
+     * @return The lifetime of the service, or std::nullopt if unknown or not registered.
+     */
+    virtual std::optional<ServiceLifetime> getLifetime(const std::type_index &type) {
+        (void)type;
+        return std::nullopt;
+    }
+    /**
+     * @brief Gets the lifetime a service with a contract was registered with.
+     * @param type The type of the service.
+     * @param contract The contract for the service.
+     * @return The lifetime of the service, or std::nullopt if unknown or not registered.
+     */
+    virtual std::optional<ServiceLifetime> getLifetime(const std::type_index &type, const std::string &contract) {
+        (void)type;
+        (void)contract;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Borrows the shared instance of a constant or lazy singleton.
+     *
+     * The returned pointer refers to the instance stored by the container and
+     * stays valid until the service is unregistered or the container is
+     * destroyed; lazy singletons are constructed on first borrow. The default
+     * implementation does not support borrowing.
+     * @param slot The slot of the type, as returned by typeSlot().
+     * @param type The type of the service.
+     * @param contract The interned contract for the service.
+     * @return The instance, or nullptr if the service is not registered, is transient, or borrowing is not supported.
+     */
+    virtual const std::any *borrowService(std::size_t slot, const std::type_index &type, ContractId contract) {
+        (void)slot;
+        (void)type;
+        (void)contract;
+        return nullptr;
+    }
+
+    /**
+     * @brief Gets the registration entry of a service.
+     *
+     * Used by ServiceHandle to resolve a service repeatedly without going
+     * through the container. Handles keep the entry until invalidateServices()
+     * is called or a default container changes, so containers that expose
+     * entries must call invalidateServices() whenever their registrations
+     * change. The default implementation exposes no entries, so handles fall
+     * back to getService().
+     * @param slot The slot of the type, as returned by typeSlot().
+     * @param type The type of the service.
+     * @param contract The interned contract for the service.
+     * @return The entry, or nullptr if the service is not registered or entries are not supported.
+     */
+    virtual std::shared_ptr<ServiceEntry> getEntry(std::size_t slot, const std::type_index &type, ContractId contract) {
+        (void)slot;
+        (void)type;
+        (void)contract;
+        return nullptr;
+    }
+
+    /**
+     * @brief Lists the registration entries of the container.
+     *
+     * Used by warmUp() to find the lazy singletons to construct ahead of
+     * traffic. Entries inherited from a parent container are not listed. The
+     * default implementation exposes no entries.
+     * @return The entries.
+     */
+    virtual std::vector<RegisteredEntry> getEntries() {
+        return {};
+    }
 
     /**
      * @brief Registers a factory for a service.
@@ -83,6 +336,155 @@ public:
      */
     virtual bool registerConstant(const std::type_index &type, const std::string &contract, std::any service) = 0;
 
+    /**
+     * @brief Registers a scoped factory for a service.
+     *
+     * A scoped service is created once per Scope and resolved through it;
+     * getService() outside of a scope does not find it. The default
+     * implementation does not support scoped services.
+     * @param type The type of the service.
+     * @param factory The factory function, called with the scope that resolves the service.
+     * @return True if the service was registered, false otherwise.
+     */
+    virtual bool registerScoped(const std::type_index &type, std::function<std::shared_ptr<void>(Scope &)> factory) {
+        (void)type;
+        (void)factory;
+        return false;
+    }
+    /**
+     * @brief Registers a scoped factory for a service with a contract.
+     * @param type The type of the service.
+     * @param contract The contract for the service.
+     * @param factory The factory function, called with the scope that resolves the service.
+     * @return True if the service was registered, false otherwise.
+     */
+    virtual bool registerScoped(const std::type_index &type, const std::string &contract, std::function<std::shared_ptr<void>(Scope &)> factory) {
+        (void)type;
+        (void)contract;
+        (void)factory;
+        return false;
+    }
+
+    /**
+     * @brief Registers a pooled service.
+     *
+     * The factory takes an instance from a pool on every call, so it must not
+     * be cached like a singleton. The default implementation registers it as
+     * a transient service.
+     * @param type The type of the service.
+     * @param factory The factory function that acquires an instance from the pool.
+     * @return True if the service was registered, false otherwise.
+     */
+    virtual bool registerPooled(const std::type_index &type, std::function<std::any()> factory) {
+        return registerService(type, std::move(factory));
+    }
+    /**
+     * @brief Registers a pooled service with a contract.
+     * @param type The type of the service.
+     * @param contract The contract for the service.
+     * @param factory The factory function that acquires an instance from the pool.
+     * @return True if the service was registered, false otherwise.
+     */
+    virtual bool registerPooled(const std::type_index &type, const std::string &contract, std::function<std::any()> factory) {
+        return registerService(type, contract, std::move(factory));
+    }
+
+    /**
+     * @brief Registers a factory for a transient, lazy singleton or pooled service.
+     *
+     * The templated registration functions go through this entry point, so
+     * containers that store ServiceFactory directly register callables
+     * without copying them into a std::function. The default implementation
+     * wraps the factory into a std::function and registers it with
+     * registerService(), registerLazySingleton() or registerPooled().
+     * @param type The type of the service.
+     * @param lifetime The lifetime of the service: Transient, LazySingleton or Pooled.
+     * @param factory The factory.
+     * @return True if the service was registered, false otherwise.
+     */
+    virtual bool registerFactory(const std::type_index &type, ServiceLifetime lifetime, ServiceFactory factory) {
+        std::function<std::any()> wrapped = wrapFactory(std::move(factory));
+        switch (lifetime) {
+        case ServiceLifetime::Transient:
+            return registerService(type, std::move(wrapped));
+        case ServiceLifetime::LazySingleton:
+            return registerLazySingleton(type, std::move(wrapped));
+        case ServiceLifetime::Pooled:
+            return registerPooled(type, std::move(wrapped));
+        default:
+            return false;
+        }
+    }
+    /**
+     * @brief Registers a factory for a transient, lazy singleton or pooled service with a contract.
+     * @param type The type of the service.
+     * @param contract The contract for the service.
+     * @param lifetime The lifetime of the service: Transient, LazySingleton or Pooled.
+     * @param factory The factory.
+     * @return True if the service was registered, false otherwise.
+     */
+    virtual bool registerFactory(const std::type_index &type, const std::string &contract, ServiceLifetime lifetime, ServiceFactory factory) {
+        std::function<std::any()> wrapped = wrapFactory(std::move(factory));
+        switch (lifetime) {
+        case ServiceLifetime::Transient:
+            return registerService(type, contract, std::move(wrapped));
+        case ServiceLifetime::LazySingleton:
+            return registerLazySingleton(type, contract, std::move(wrapped));
+        case ServiceLifetime::Pooled:
+            return registerPooled(type, contract, std::move(wrapped));
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief Registers a batch of services.
+     *
+     * Containers can override this to apply the whole batch under a single
+     * lock and report duplicates once. The default implementation registers
+     * the services one by one.
+     * @param registrations The registrations.
+     * @return The number of services registered.
+     */
+    virtual std::size_t registerBatch(std::vector<ServiceRegistration> registrations) {
+        std::size_t registered = 0;
+        for (ServiceRegistration &registration : registrations) {
+            registered += registerOne(registration) ? 1 : 0;
+        }
+
+        return registered;
+    }
+
+    /**
+     * @brief Registers a batch of services, all of them or none.
+     *
+     * Containers can override this to check and apply the whole batch under
+     * a single lock, so no other thread sees part of it. The default
+     * implementation registers the services one by one and unregisters them
+     * again if one fails.
+     * @param registrations The registrations.
+     * @return True if every service was registered, false if none was.
+     */
+    virtual bool registerAll(std::vector<ServiceRegistration> registrations) {
+        for (std::size_t i = 0; i < registrations.size(); ++i) {
+            if (registerOne(registrations[i])) {
+                continue;
+            }
+
+            while (i--) {
+                const ServiceRegistration &registered = registrations[i];
+                if (registered.contract) {
+                    unregisterService(registered.type, *registered.contract);
+                } else {
+                    unregisterService(registered.type);
+                }
+            }
+            return false;
+        }
+
+        return true;
+    }
+
     /**
      * @brief Unregisters a service.
      * @param type The type of the service.
@@ -94,6 +496,36 @@ public:
      * @param contract The contract for the service.
      */
     virtual void unregisterService(const std::type_index &type, const std::string &contract) = 0;
+
+    /**
+     * @brief Unregisters several services at once.
+     *
+     * Containers can override this to remove the services under a single
+     * lock, so no other thread sees some of them gone and others still
+     * registered. The default implementation unregisters them one by one.
+     * @param services The services.
+     */
+    virtual void unregisterAll(const std::vector<ServiceKey> &services) {
+        for (const ServiceKey &service : services) {
+            if (service.contract) {
+                unregisterService(service.type, *service.contract);
+            } else {
+                unregisterService(service.type);
+            }
+        }
+    }
+
+    /**
+     * @brief Freezes the registrations of the container.
+     *
+     * Containers that support freezing compile their registrations into an
+     * immutable table that can be read without locking; further registrations
+     * are rejected. The default implementation does nothing.
+     * @return True if the container is frozen, false if freezing is not supported.
+     */
+    virtual bool freeze() {
+        return false;
+    }
 };
 }
 #endif // SERVICES_INTERFACE_H
\ No newline at end of file
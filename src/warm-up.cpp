@@ -0,0 +1,267 @@
+/**
+ * @file warm-up.cpp
+ * @brief Implements the eager, parallel construction of lazy singletons.
+ */
+
+#include "warm-up.h"
+#include "container-manager.h"
+#include "service-entry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace PureIOC {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief A lazy singleton to warm up.
+ */
+struct Node {
+    std::size_t slot;
+    ContractId contract;
+    std::shared_ptr<ServiceEntry> entry;
+    std::vector<std::size_t> dependents; ///< The nodes waiting for this one.
+    std::size_t dependencies = 0;        ///< The number of nodes this one waits for.
+};
+
+/**
+ * @brief The ready nodes of a worker, popped from the back by their owner and stolen from the front by the others.
+ */
+struct alignas(64) WorkQueue {
+    std::mutex mutex;
+    std::deque<std::size_t> nodes;
+};
+
+/**
+ * @brief Orders the nodes so that dependencies come before their dependents.
+ * @param nodes The nodes.
+ * @return The nodes in order; nodes caught in or behind a cycle are left out.
+ */
+std::vector<std::size_t> order(const std::vector<Node> &nodes) {
+    std::vector<std::size_t> pending(nodes.size());
+    std::vector<std::size_t> ordered;
+    ordered.reserve(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        pending[i] = nodes[i].dependencies;
+        if (pending[i] == 0) {
+            ordered.push_back(i);
+        }
+    }
+
+    for (std::size_t next = 0; next < ordered.size(); ++next) {
+        for (std::size_t dependent : nodes[ordered[next]].dependents) {
+            if (--pending[dependent] == 0) {
+                ordered.push_back(dependent);
+            }
+        }
+    }
+
+    return ordered;
+}
+
+/**
+ * @brief Runs the nodes on a pool of work-stealing threads.
+ */
+class Scheduler {
+private:
+    std::vector<Node> &_nodes;
+    std::vector<WarmUpResult> &_results;
+    std::unique_ptr<std::atomic<std::size_t>[]> _pending;
+    std::unique_ptr<WorkQueue[]> _queues;
+    std::size_t _workers;
+    std::atomic<std::size_t> _remaining;
+    std::atomic<std::size_t> _queued{0};
+    std::mutex _idleMutex;
+    std::condition_variable _idle;
+
+    void push(std::size_t worker, std::size_t node) {
+        {
+            std::lock_guard<std::mutex> lock(_queues[worker].mutex);
+            _queues[worker].nodes.push_back(node);
+        }
+        _queued.fetch_add(1, std::memory_order_release);
+
+        std::lock_guard<std::mutex> lock(_idleMutex);
+        _idle.notify_one();
+    }
+
+    bool pop(std::size_t worker, std::size_t &node) {
+        for (std::size_t i = 0; i < _workers; ++i) {
+            WorkQueue &queue = _queues[(worker + i) % _workers];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.nodes.empty()) {
+                continue;
+            }
+
+            if (i == 0) {
+                node = queue.nodes.back();
+                queue.nodes.pop_back();
+            } else {
+                node = queue.nodes.front();
+                queue.nodes.pop_front();
+            }
+            _queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+    void execute(std::size_t worker, std::size_t node) {
+        ServiceEntry &entry = *_nodes[node].entry;
+        WarmUpResult &result = _results[node];
+
+        const bool ready = entry.peek() != nullptr;
+        const Clock::time_point start = Clock::now();
+        try {
+            entry.borrow();
+        } catch (...) {
+            result.error = std::current_exception();
+        }
+        result.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+        result.constructed = !ready && !result.error;
+
+        for (std::size_t dependent : _nodes[node].dependents) {
+            if (_pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                push(worker, dependent);
+            }
+        }
+
+        if (_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(_idleMutex);
+            _idle.notify_all();
+        }
+    }
+
+public:
+    Scheduler(std::vector<Node> &nodes, std::vector<WarmUpResult> &results, std::size_t workers)
+        : _nodes(nodes), _results(results), _pending(new std::atomic<std::size_t>[nodes.size()]),
+          _queues(new WorkQueue[workers]), _workers(workers), _remaining(nodes.size()) {
+        std::size_t worker = 0;
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            _pending[i].store(nodes[i].dependencies, std::memory_order_relaxed);
+            if (nodes[i].dependencies == 0) {
+                _queues[worker].nodes.push_back(i);
+                _queued.fetch_add(1, std::memory_order_relaxed);
+                worker = (worker + 1) % workers;
+            }
+        }
+    }
+
+    void work(std::size_t worker) {
+        for (;;) {
+            std::size_t node;
+            if (pop(worker, node)) {
+                execute(worker, node);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_idleMutex);
+            _idle.wait(lock, [this] {
+                return _queued.load(std::memory_order_acquire) > 0 || _remaining.load(std::memory_order_acquire) == 0;
+            });
+            if (_remaining.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+};
+}
+
+std::vector<WarmUpResult> WarmUpPlan::run() const {
+    using NodeKey = std::pair<std::size_t, std::uint32_t>;
+
+    std::vector<Node> nodes;
+    std::map<NodeKey, std::size_t> indices;
+    for (RegisteredEntry &registered : currentContainer()->getEntries()) {
+        if (registered.entry->lifetime() != ServiceLifetime::LazySingleton) {
+            continue;
+        }
+
+        if (!_included.empty() && std::find(_included.begin(), _included.end(), Key(registered.slot, registered.contract)) == _included.end()) {
+            continue;
+        }
+
+        indices.emplace(NodeKey(registered.slot, registered.contract.value()), nodes.size());
+        nodes.push_back(Node{registered.slot, registered.contract, std::move(registered.entry), {}, 0});
+    }
+
+    if (nodes.empty()) {
+        return {};
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    for (const auto &[dependent, dependency] : _dependencies) {
+        auto from = indices.find(NodeKey(dependency.first, dependency.second.value()));
+        auto to = indices.find(NodeKey(dependent.first, dependent.second.value()));
+        if (from != indices.end() && to != indices.end() && from->second != to->second) {
+            edges.emplace_back(from->second, to->second);
+        }
+    }
+
+    auto link = [&](auto keep) {
+        for (Node &node : nodes) {
+            node.dependents.clear();
+            node.dependencies = 0;
+        }
+        for (const auto &[from, to] : edges) {
+            if (keep(from, to)) {
+                nodes[from].dependents.push_back(to);
+                ++nodes[to].dependencies;
+            }
+        }
+    };
+
+    link([](std::size_t, std::size_t) { return true; });
+    std::vector<std::size_t> ordered = order(nodes);
+    if (ordered.size() != nodes.size()) {
+        std::vector<bool> acyclic(nodes.size(), false);
+        for (std::size_t i : ordered) {
+            acyclic[i] = true;
+        }
+
+        link([&](std::size_t from, std::size_t to) { return acyclic[from] || acyclic[to]; });
+        ordered = order(nodes);
+    }
+
+    std::vector<WarmUpResult> results;
+    results.reserve(nodes.size());
+    for (const Node &node : nodes) {
+        results.push_back(WarmUpResult{slotType(node.slot), node.contract, std::chrono::nanoseconds(0), false, nullptr});
+    }
+
+    std::size_t workers = _threads != 0 ? _threads : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    workers = std::min(workers, nodes.size());
+
+    Scheduler scheduler(nodes, results, workers);
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (std::size_t worker = 1; worker < workers; ++worker) {
+        threads.emplace_back([&scheduler, worker] { scheduler.work(worker); });
+    }
+    scheduler.work(0);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<WarmUpResult> sorted;
+    sorted.reserve(results.size());
+    for (std::size_t i : ordered) {
+        sorted.push_back(std::move(results[i]));
+    }
+
+    return sorted;
+}
+
+std::vector<WarmUpResult> warmUp(std::size_t threads) {
+    return WarmUpPlan().threads(threads).run();
+}
+}
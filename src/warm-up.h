@@ -0,0 +1,106 @@
+/**
+ * @file warm-up.h
+ * @brief This file contains the eager, parallel construction of lazy singletons.
+ */
+
+#ifndef WARM_UP_H
+#define WARM_UP_H
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+#include "contract-id.h"
+#include "service-slot.h"
+
+namespace PureIOC {
+/**
+ * @brief The outcome of warming up one lazy singleton.
+ */
+struct WarmUpResult {
+    std::type_index type;              ///< The type of the service.
+    ContractId contract;               ///< The interned contract of the service.
+    std::chrono::nanoseconds duration; ///< The time spent getting the instance.
+    bool constructed;                  ///< Whether the warm-up constructed the instance, rather than finding it ready.
+    std::exception_ptr error;          ///< The exception thrown by the factory, if any.
+};
+
+/**
+ * @brief Constructs lazy singletons ahead of traffic on a pool of threads.
+ *
+ * The plan warms every lazy singleton registered in the current container, or
+ * only the ones selected with include(). Singletons are constructed through
+ * the once flag of their registration entry, so a warm-up racing with an
+ * ordinary resolution never constructs an instance twice.
+ *
+ * Declared dependencies order the construction: a singleton starts only once
+ * the singletons it depends on are ready, while independent singletons are
+ * constructed concurrently. Each worker keeps its own queue and pushes the
+ * singletons its work made ready onto it; idle workers steal from the others.
+ * Dependencies on services that are not warmed up are ignored, and so are
+ * the dependencies among singletons caught in or behind a cycle, whose
+ * factories then resolve their dependencies on demand as usual.
+ */
+class WarmUpPlan {
+private:
+    using Key = std::pair<std::size_t, ContractId>;
+
+    std::vector<Key> _included;
+    std::vector<std::pair<Key, Key>> _dependencies;
+    std::size_t _threads = 0;
+
+public:
+    /**
+     * @brief Selects a singleton to warm up; without selection, all are warmed up.
+     * @tparam T The type of the service.
+     * @param contract The interned contract for the service, see internContract().
+     * @return The plan.
+     */
+    template <class T>
+    WarmUpPlan &include(ContractId contract = ContractId()) {
+        _included.emplace_back(typeSlot<T>(), contract);
+        return *this;
+    }
+
+    /**
+     * @brief Declares that a singleton is to be constructed after another.
+     * @tparam T The type of the dependent service.
+     * @tparam D The type of the service it depends on.
+     * @param contract The interned contract for the dependent service.
+     * @param dependencyContract The interned contract for the service it depends on.
+     * @return The plan.
+     */
+    template <class T, class D>
+    WarmUpPlan &dependsOn(ContractId contract = ContractId(), ContractId dependencyContract = ContractId()) {
+        _dependencies.emplace_back(Key(typeSlot<T>(), contract), Key(typeSlot<D>(), dependencyContract));
+        return *this;
+    }
+
+    /**
+     * @brief Sets the number of threads, the calling thread included.
+     * @param count The number of threads, or 0 for the hardware concurrency.
+     * @return The plan.
+     */
+    WarmUpPlan &threads(std::size_t count) noexcept {
+        _threads = count;
+        return *this;
+    }
+
+    /**
+     * @brief Runs the warm-up, returning once every singleton is ready or has failed.
+     * @return The outcome for each singleton, dependencies before their dependents.
+     */
+    std::vector<WarmUpResult> run() const;
+};
+
+/**
+ * @brief Constructs every lazy singleton of the current container on a pool of threads.
+ * @param threads The number of threads, the calling thread included, or 0 for the hardware concurrency.
+ * @return The outcome for each singleton.
+ */
+std::vector<WarmUpResult> warmUp(std::size_t threads = 0);
+}
+#endif // WARM_UP_H
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include <async-services.h>
+#include <container-manager.h>
+#include <locator.h>
+#include <locator-mutable.h>
+
+namespace {
+struct Database {
+    int id = 0;
+};
+
+bool isReady(const std::shared_future<std::shared_ptr<Database>> &future) {
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+class AsyncServicesTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        PureIOC::registerContainer(PureIOC::ContainerOptions());
+    }
+
+    void TearDown() override {
+        PureIOC::registerContainer(nullptr);
+    }
+};
+}
+
+TEST_F(AsyncServicesTest, SingletonResolvesWithoutWaiting) {
+    std::promise<std::shared_ptr<Database>> pending;
+    std::atomic<int> calls{0};
+    ASSERT_TRUE(PureIOC::registerAsyncSingleton<Database>([&] {
+        ++calls;
+        return pending.get_future();
+    }));
+
+    std::shared_future<std::shared_ptr<Database>> future = PureIOC::getServiceAsync<Database>();
+    EXPECT_FALSE(isReady(future));
+    EXPECT_FALSE(isReady(PureIOC::getServiceAsync<Database>()));
+
+    auto database = std::make_shared<Database>();
+    pending.set_value(database);
+
+    EXPECT_TRUE(isReady(future));
+    EXPECT_EQ(database, future.get());
+    EXPECT_EQ(database, PureIOC::getService<Database>());
+    EXPECT_EQ(1, calls.load());
+}
+
+TEST_F(AsyncServicesTest, SynchronousResolutionWaitsForTheFactory) {
+    std::promise<std::shared_ptr<Database>> pending;
+    ASSERT_TRUE(PureIOC::registerAsyncSingleton<Database>([&] { return pending.get_future().share(); }));
+
+    std::shared_ptr<Database> resolved;
+    std::thread waiter([&] { resolved = PureIOC::getService<Database>(); });
+
+    auto database = std::make_shared<Database>();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    pending.set_value(database);
+    waiter.join();
+
+    EXPECT_EQ(database, resolved);
+}
+
+TEST_F(AsyncServicesTest, TransientCallsTheFactoryOnEveryResolution) {
+    std::atomic<int> calls{0};
+    ASSERT_TRUE(PureIOC::registerAsyncService<Database>([&] {
+        const int id = ++calls;
+        return std::async(std::launch::async, [id] {
+            auto database = std::make_shared<Database>();
+            database->id = id;
+            return database;
+        });
+    }));
+
+    std::shared_ptr<Database> first = PureIOC::getServiceAsync<Database>().get();
+    std::shared_ptr<Database> second = PureIOC::getServiceAsync<Database>().get();
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(1, first->id);
+    EXPECT_EQ(2, second->id);
+}
+
+TEST_F(AsyncServicesTest, ContractAndFailingFactoryIsRetried) {
+    std::atomic<int> calls{0};
+    auto database = std::make_shared<Database>();
+    ASSERT_TRUE(PureIOC::registerAsyncSingleton<Database>("replica", [&]() -> std::future<std::shared_ptr<Database>> {
+        if (++calls == 1) {
+            throw std::runtime_error("connection refused");
+        }
+        std::promise<std::shared_ptr<Database>> ready;
+        ready.set_value(database);
+        return ready.get_future();
+    }));
+
+    std::shared_future<std::shared_ptr<Database>> future = PureIOC::getServiceAsync<Database>("replica");
+    EXPECT_TRUE(isReady(future));
+    EXPECT_THROW(future.get(), std::runtime_error);
+    EXPECT_EQ(nullptr, PureIOC::getServiceAsync<Database>().get());
+
+    EXPECT_EQ(database, PureIOC::getService<Database>("replica"));
+    EXPECT_EQ(database, PureIOC::getServiceAsync<Database>("replica").get());
+    EXPECT_EQ(2, calls.load());
+}
+
+TEST_F(AsyncServicesTest, SingletonWhoseFutureFailedIsStartedAgain) {
+    std::promise<std::shared_ptr<Database>> first;
+    std::promise<std::shared_ptr<Database>> second;
+    std::atomic<int> calls{0};
+    ASSERT_TRUE(PureIOC::registerAsyncSingleton<Database>([&] {
+        return ++calls == 1 ? first.get_future() : second.get_future();
+    }));
+
+    std::shared_future<std::shared_ptr<Database>> failing = PureIOC::getServiceAsync<Database>();
+    first.set_exception(std::make_exception_ptr(std::runtime_error("timed out")));
+    EXPECT_THROW(failing.get(), std::runtime_error);
+
+    std::shared_future<std::shared_ptr<Database>> retried = PureIOC::getServiceAsync<Database>();
+    EXPECT_FALSE(isReady(retried));
+    auto database = std::make_shared<Database>();
+    second.set_value(database);
+
+    EXPECT_EQ(database, retried.get());
+    EXPECT_EQ(database, PureIOC::getService<Database>());
+    EXPECT_EQ(2, calls.load());
+}
+
+TEST_F(AsyncServicesTest, OtherServicesResolveToReadyFutures) {
+    EXPECT_EQ(nullptr, PureIOC::getServiceAsync<Database>().get());
+    EXPECT_EQ(nullptr, PureIOC::getServiceAsync<Database>("never interned contract").get());
+
+    auto database = std::make_shared<Database>();
+    PureIOC::registerConstant<Database, Database>(database);
+
+    std::shared_future<std::shared_ptr<Database>> future = PureIOC::getServiceAsync<Database>();
+    EXPECT_TRUE(isReady(future));
+    EXPECT_EQ(database, future.get());
+}
+
+TEST_F(AsyncServicesTest, RegistrationIsAllOrNothing) {
+    PureIOC::registerConstant<Database, Database>(std::make_shared<Database>());
+    const std::uint64_t generation = PureIOC::servicesGeneration();
+    EXPECT_FALSE(PureIOC::registerAsyncSingleton<Database>([] { return std::promise<std::shared_ptr<Database>>().get_future(); }));
+    EXPECT_EQ(generation, PureIOC::servicesGeneration());
+
+    PureIOC::unregister<Database>();
+    std::promise<std::shared_ptr<Database>> pending;
+    ASSERT_TRUE(PureIOC::registerAsyncSingleton<Database>([&] { return pending.get_future(); }));
+    EXPECT_FALSE(isReady(PureIOC::getServiceAsync<Database>()));
+
+    PureIOC::unregisterAsync<Database>();
+    EXPECT_EQ(nullptr, PureIOC::getServiceAsync<Database>().get());
+}
+
+TEST_F(AsyncServicesTest, UnregistrationRemovesBothRegistrationsAtOnce) {
+    ASSERT_TRUE(PureIOC::registerAsyncSingleton<Database>("primary", [] { return std::promise<std::shared_ptr<Database>>().get_future(); }));
+    const std::uint64_t generation = PureIOC::servicesGeneration();
+
+    PureIOC::unregisterAsync<Database>("primary");
+    EXPECT_EQ(generation + 1, PureIOC::servicesGeneration());
+    EXPECT_EQ(nullptr, PureIOC::getServiceAsync<Database>(PureIOC::internContract("primary")).get());
+    EXPECT_TRUE(PureIOC::registerAsyncSingleton<Database>("primary", [] { return std::promise<std::shared_ptr<Database>>().get_future(); }));
+}
@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <auto-wiring.h>
+#include <container-manager.h>
+#include <internal/default-services.h>
+#include <locator.h>
+#include <locator-mutable.h>
+
+namespace {
+struct Clock {
+    virtual ~Clock() = default;
+};
+
+struct ClockImpl : public Clock {};
+
+struct Repository {
+    virtual ~Repository() = default;
+    virtual std::shared_ptr<Clock> clock() const = 0;
+};
+
+struct RepositoryImpl : public Repository {
+    explicit RepositoryImpl(std::shared_ptr<Clock> clock) : _clock(std::move(clock)) {}
+
+    std::shared_ptr<Clock> clock() const override {
+        return _clock;
+    }
+
+    std::shared_ptr<Clock> _clock;
+};
+
+struct Handler {
+    virtual ~Handler() = default;
+};
+
+struct HandlerImpl : public Handler {
+    HandlerImpl(std::shared_ptr<Repository> repository, std::shared_ptr<Clock> clock)
+        : repository(std::move(repository)), clock(std::move(clock)) {}
+
+    std::shared_ptr<Repository> repository;
+    std::shared_ptr<Clock> clock;
+};
+
+/**
+ * Forwards to a default container, counting the lookups that reach it.
+ */
+class CountingServices final : public PureIOC::IServices {
+public:
+    PureIOC::internal::DefaultServices inner;
+    int lookups = 0;
+
+    std::optional<std::any> getService(const std::type_index &type) override {
+        ++lookups;
+        return inner.getService(type);
+    }
+    std::optional<std::any> getService(const std::type_index &type, const std::string &contract) override {
+        ++lookups;
+        return inner.getService(type, contract);
+    }
+    std::optional<std::any> getService(std::size_t slot, const std::type_index &type) override {
+        ++lookups;
+        return inner.getService(slot, type);
+    }
+    std::optional<std::any> getService(std::size_t slot, const std::type_index &type, PureIOC::ContractId contract) override {
+        ++lookups;
+        return inner.getService(slot, type, contract);
+    }
+    std::shared_ptr<PureIOC::ServiceEntry> getEntry(std::size_t slot, const std::type_index &type, PureIOC::ContractId contract) override {
+        ++lookups;
+        return inner.getEntry(slot, type, contract);
+    }
+    bool registerService(const std::type_index &type, std::function<std::any()> factory) override {
+        return inner.registerService(type, std::move(factory));
+    }
+    bool registerService(const std::type_index &type, const std::string &contract, std::function<std::any()> factory) override {
+        return inner.registerService(type, contract, std::move(factory));
+    }
+    bool registerLazySingleton(const std::type_index &type, std::function<std::any()> factory) override {
+        return inner.registerLazySingleton(type, std::move(factory));
+    }
+    bool registerLazySingleton(const std::type_index &type, const std::string &contract, std::function<std::any()> factory) override {
+        return inner.registerLazySingleton(type, contract, std::move(factory));
+    }
+    bool registerConstant(const std::type_index &type, std::any service) override {
+        return inner.registerConstant(type, std::move(service));
+    }
+    bool registerConstant(const std::type_index &type, const std::string &contract, std::any service) override {
+        return inner.registerConstant(type, contract, std::move(service));
+    }
+    bool registerFactory(const std::type_index &type, PureIOC::ServiceLifetime lifetime, PureIOC::ServiceFactory factory) override {
+        return inner.registerFactory(type, lifetime, std::move(factory));
+    }
+    void unregisterService(const std::type_index &type) override {
+        inner.unregisterService(type);
+    }
+    void unregisterService(const std::type_index &type, const std::string &contract) override {
+        inner.unregisterService(type, contract);
+    }
+};
+
+class AutoWiringTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        PureIOC::registerContainer(PureIOC::ContainerOptions());
+    }
+
+    void TearDown() override {
+        PureIOC::registerContainer(nullptr);
+    }
+};
+}
+
+TEST_F(AutoWiringTest, ConstructorReceivesRegisteredDependencies) {
+    auto clock = std::make_shared<ClockImpl>();
+    PureIOC::registerConstant<Clock, ClockImpl>(clock);
+    ASSERT_TRUE((PureIOC::registerType<Repository, RepositoryImpl, Clock>()));
+    ASSERT_TRUE((PureIOC::registerType<Handler, HandlerImpl, Repository, Clock>()));
+
+    auto handler = std::static_pointer_cast<HandlerImpl>(PureIOC::getService<Handler>());
+    ASSERT_NE(nullptr, handler);
+    EXPECT_EQ(clock, handler->clock);
+    ASSERT_NE(nullptr, handler->repository);
+    EXPECT_EQ(clock, handler->repository->clock());
+    EXPECT_NE(handler->repository, std::static_pointer_cast<HandlerImpl>(PureIOC::getService<Handler>())->repository);
+}
+
+TEST_F(AutoWiringTest, MissingDependencyIsNull) {
+    ASSERT_TRUE((PureIOC::registerType<Repository, RepositoryImpl, Clock>()));
+
+    auto repository = PureIOC::getService<Repository>();
+    ASSERT_NE(nullptr, repository);
+    EXPECT_EQ(nullptr, repository->clock());
+
+    auto clock = std::make_shared<ClockImpl>();
+    PureIOC::registerConstant<Clock, ClockImpl>(clock);
+    EXPECT_EQ(clock, PureIOC::getService<Repository>()->clock());
+}
+
+TEST_F(AutoWiringTest, LazySingletonWithContract) {
+    PureIOC::registerConstant<Clock, ClockImpl>(std::make_shared<ClockImpl>());
+    ASSERT_TRUE((PureIOC::registerType<Repository, RepositoryImpl, Clock>("shared", PureIOC::ServiceLifetime::LazySingleton)));
+
+    EXPECT_EQ(PureIOC::getService<Repository>("shared"), PureIOC::getService<Repository>("shared"));
+    EXPECT_EQ(nullptr, PureIOC::getService<Repository>());
+}
+
+TEST_F(AutoWiringTest, BoundPlanSkipsLocatorLookups) {
+    auto services = std::make_shared<CountingServices>();
+    PureIOC::registerContainer(services);
+    PureIOC::registerConstant<Clock, ClockImpl>(std::make_shared<ClockImpl>());
+    PureIOC::registerType<Repository, RepositoryImpl, Clock>();
+    PureIOC::registerType<Handler, HandlerImpl, Repository, Clock>();
+
+    PureIOC::getService<Handler>();
+    services->lookups = 0;
+    PureIOC::getService<Handler>();
+
+    EXPECT_EQ(1, services->lookups);
+}
+
+TEST_F(AutoWiringTest, RejectsLifetimesWithoutFactory) {
+    EXPECT_FALSE((PureIOC::registerType<Repository, RepositoryImpl, Clock>(PureIOC::ServiceLifetime::Constant)));
+    EXPECT_FALSE((PureIOC::registerType<Repository, RepositoryImpl, Clock>(PureIOC::ServiceLifetime::Scoped)));
+    EXPECT_FALSE((PureIOC::registerType<Repository, RepositoryImpl, Clock>("scoped", PureIOC::ServiceLifetime::Scoped)));
+    EXPECT_EQ(nullptr, PureIOC::getService<Repository>());
+    EXPECT_EQ(nullptr, PureIOC::getService<Repository>("scoped"));
+}
+
+TEST_F(AutoWiringTest, DependenciesWithContracts) {
+    auto local = std::make_shared<ClockImpl>();
+    auto utc = std::make_shared<ClockImpl>();
+    PureIOC::registerConstant<Clock, ClockImpl>(local);
+    PureIOC::registerConstant<Clock, ClockImpl>("utc", utc);
+    ASSERT_TRUE((PureIOC::registerType<Repository, RepositoryImpl, Clock>(PureIOC::ServiceLifetime::Transient, {PureIOC::internContract("utc")})));
+    ASSERT_TRUE((PureIOC::registerType<Handler, HandlerImpl, Repository, Clock>("handler", PureIOC::ServiceLifetime::Transient, {PureIOC::ContractId(), PureIOC::internContract("utc")})));
+
+    EXPECT_EQ(utc, PureIOC::getService<Repository>()->clock());
+    auto handler = std::static_pointer_cast<HandlerImpl>(PureIOC::getService<Handler>("handler"));
+    ASSERT_NE(nullptr, handler);
+    EXPECT_EQ(utc, handler->clock);
+    EXPECT_EQ(utc, handler->repository->clock());
+}
+
+TEST_F(AutoWiringTest, ReplacedContainerReleasesBoundDependencies) {
+    std::weak_ptr<ClockImpl> clock;
+    {
+        auto instance = std::make_shared<ClockImpl>();
+        clock = instance;
+        PureIOC::registerConstant<Clock, ClockImpl>(instance);
+    }
+    ASSERT_TRUE((PureIOC::registerType<Repository, RepositoryImpl, Clock>()));
+    ASSERT_NE(nullptr, PureIOC::getService<Repository>());
+    ASSERT_NE(nullptr, PureIOC::getService<Repository>());
+
+    PureIOC::registerContainer(PureIOC::ContainerOptions());
+    EXPECT_TRUE(clock.expired());
+}
+
+TEST_F(AutoWiringTest, UnregisteredDependencyIsReleased) {
+    std::weak_ptr<ClockImpl> clock;
+    {
+        auto instance = std::make_shared<ClockImpl>();
+        clock = instance;
+        PureIOC::registerConstant<Clock, ClockImpl>(instance);
+    }
+    ASSERT_TRUE((PureIOC::registerType<Repository, RepositoryImpl, Clock>()));
+    ASSERT_NE(nullptr, PureIOC::getService<Repository>());
+
+    PureIOC::unregister<Clock>();
+    EXPECT_TRUE(clock.expired());
+    EXPECT_EQ(nullptr, PureIOC::getService<Repository>()->clock());
+}
+
+TEST_F(AutoWiringTest, BoundDependencyDoesNotKeepRegistrationAlive) {
+    ASSERT_TRUE((PureIOC::registerType<Repository, RepositoryImpl, Clock>(PureIOC::ServiceLifetime::LazySingleton)));
+    ASSERT_TRUE((PureIOC::registerType<Handler, HandlerImpl, Repository, Clock>()));
+    ASSERT_NE(nullptr, PureIOC::getService<Handler>());
+    std::weak_ptr<Repository> repository = PureIOC::getService<Repository>();
+    ASSERT_FALSE(repository.expired());
+
+    PureIOC::unregister<Repository>();
+    EXPECT_TRUE(repository.expired());
+}
+
+TEST_F(AutoWiringTest, ConcurrentConstructionsShareRegistration) {
+    auto clock = std::make_shared<ClockImpl>();
+    PureIOC::registerConstant<Clock, ClockImpl>(clock);
+    ASSERT_TRUE((PureIOC::registerType<Repository, RepositoryImpl, Clock>()));
+    ASSERT_TRUE((PureIOC::registerType<Handler, HandlerImpl, Repository, Clock>()));
+
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 16; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 100; ++i) {
+                auto handler = std::static_pointer_cast<HandlerImpl>(PureIOC::getService<Handler>());
+                if (!handler || handler->clock != clock || handler->repository->clock() != clock) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(0, mismatches.load());
+}
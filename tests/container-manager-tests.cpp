@@ -1,10 +1,18 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
 #include <thread>
 #include <vector>
 
 #include <container-manager.h>
+#include <locator.h>
+#include <locator-mutable.h>
 #include <services-interface.h>
 
 namespace {
@@ -61,6 +69,64 @@ public:
     MOCK_METHOD(void, unregisterService, (const std::type_index &, const std::string &), (override));
 };
 
+class ConfiguredServices final : public PureIOC::IServices {
+public:
+    explicit ConfiguredServices(const PureIOC::ContainerOptions &options)
+        : shards(options.shards) {}
+
+    std::size_t shards;
+
+    std::optional<std::any> getService(const std::type_index &) override {
+        return std::nullopt;
+    }
+
+    std::optional<std::any> getService(const std::type_index &, const std::string &) override {
+        return std::nullopt;
+    }
+
+    bool registerService(const std::type_index &, std::function<std::any()>) override {
+        return false;
+    }
+
+    bool registerService(const std::type_index &, const std::string &, std::function<std::any()>) override {
+        return false;
+    }
+
+    bool registerLazySingleton(const std::type_index &, std::function<std::any()>) override {
+        return false;
+    }
+
+    bool registerLazySingleton(const std::type_index &, const std::string &, std::function<std::any()>) override {
+        return false;
+    }
+
+    bool registerConstant(const std::type_index &, std::any) override {
+        return false;
+    }
+
+    bool registerConstant(const std::type_index &, const std::string &, std::any) override {
+        return false;
+    }
+
+    void unregisterService(const std::type_index &) override {}
+
+    void unregisterService(const std::type_index &, const std::string &) override {}
+};
+
+/**
+ * @brief A singleton that reports its destruction.
+ */
+struct Tracked {
+    explicit Tracked(std::atomic<bool> &destroyed)
+        : destroyed(destroyed) {}
+
+    ~Tracked() {
+        destroyed = true;
+    }
+
+    std::atomic<bool> &destroyed;
+};
+
 class ContainerManagerTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -146,3 +212,125 @@ TEST_F(ContainerManagerTest, ThreadSafety) {
         t.join();
     }
 }
+
+TEST_F(ContainerManagerTest, CurrentContainerFollowsReplacementFromAnotherThread) {
+    PureIOC::IServices *before = &PureIOC::currentContainer().get();
+    EXPECT_EQ(PureIOC::getContainer().get(), before);
+
+    auto custom = std::make_shared<DummyServices>();
+    std::thread([custom] {
+        PureIOC::registerContainer(custom);
+    }).join();
+
+    EXPECT_EQ(custom.get(), &PureIOC::currentContainer().get());
+    EXPECT_EQ(custom, PureIOC::getContainer());
+}
+
+TEST_F(ContainerManagerTest, RegisterDefaultContainerWithOptions) {
+    auto before = PureIOC::getContainer();
+
+    PureIOC::ContainerOptions options;
+    options.copyOnWrite = true;
+    PureIOC::registerContainer(options);
+
+    auto container = PureIOC::getContainer();
+    ASSERT_NE(container, nullptr);
+    EXPECT_NE(before, container);
+    EXPECT_TRUE(container->registerConstant(typeid(int), std::make_any<std::shared_ptr<int>>(std::make_shared<int>(42))));
+    EXPECT_EQ(42, *std::any_cast<std::shared_ptr<int>>(*container->getService(typeid(int))));
+}
+
+TEST_F(ContainerManagerTest, RegisterContainerByTypeWithOptions) {
+    PureIOC::ContainerOptions options;
+    options.shards = 16;
+    PureIOC::registerContainer<ConfiguredServices>(options);
+
+    auto container = std::dynamic_pointer_cast<ConfiguredServices>(PureIOC::getContainer());
+    ASSERT_NE(container, nullptr);
+    EXPECT_EQ(16u, container->shards);
+}
+
+TEST_F(ContainerManagerTest, ReplacedContainerIsReleasedOnceEveryThreadIsIdle) {
+    std::atomic<bool> destroyed{false};
+    PureIOC::registerLazySingleton<Tracked>([&destroyed] {
+        return std::make_shared<Tracked>(destroyed);
+    });
+
+    std::thread([] {
+        EXPECT_NE(nullptr, PureIOC::getService<Tracked>());
+    }).join();
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool resolved = false;
+    bool done = false;
+    std::thread idle([&] {
+        EXPECT_NE(nullptr, PureIOC::getService<Tracked>());
+        std::unique_lock<std::mutex> lock(mutex);
+        resolved = true;
+        changed.notify_all();
+        changed.wait(lock, [&] { return done; });
+    });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return resolved; });
+    }
+
+    PureIOC::cleanup();
+    EXPECT_TRUE(destroyed);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        changed.notify_all();
+    }
+    idle.join();
+}
+
+TEST_F(ContainerManagerTest, ReplacedContainerOutlivesCallsInProgress) {
+    std::atomic<bool> destroyed{false};
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    PureIOC::registerLazySingleton<Tracked>([&destroyed] {
+        return std::make_shared<Tracked>(destroyed);
+    });
+    ASSERT_NE(nullptr, PureIOC::getService<Tracked>());
+    PureIOC::registerService<int>([&] {
+        entered = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+        return std::make_shared<int>(1);
+    });
+
+    std::thread reader([] {
+        EXPECT_NE(nullptr, PureIOC::getService<int>());
+    });
+    while (!entered) {
+        std::this_thread::yield();
+    }
+
+    PureIOC::cleanup();
+    EXPECT_FALSE(destroyed);
+
+    release = true;
+    reader.join();
+    EXPECT_TRUE(destroyed);
+}
+
+TEST_F(ContainerManagerTest, ReplacedContainerAllocatedFromArenaIsReleasedInScope) {
+    {
+        std::array<std::byte, 64 * 1024> buffer;
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+        std::pmr::synchronized_pool_resource pool(&arena);
+        PureIOC::ContainerOptions options;
+        options.resource = &pool;
+        PureIOC::registerContainer(options);
+        PureIOC::registerConstant<int, int>(std::make_shared<int>(7));
+        EXPECT_EQ(7, *PureIOC::getService<int>());
+
+        PureIOC::cleanup();
+    }
+
+    EXPECT_EQ(nullptr, PureIOC::getService<int>());
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <contract-id.h>
+
+TEST(ContractId, DefaultIdHasNoContract) {
+    PureIOC::ContractId none;
+    EXPECT_FALSE(none);
+    EXPECT_EQ(0u, none.value());
+    EXPECT_EQ("", PureIOC::contractName(none));
+}
+
+TEST(ContractId, InternIsStable) {
+    auto first = PureIOC::internContract("contract-id-stable");
+    auto second = PureIOC::internContract(std::string("contract-id-stable"));
+    EXPECT_TRUE(first);
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, PureIOC::internContract("contract-id-other"));
+}
+
+TEST(ContractId, FindDoesNotIntern) {
+    EXPECT_FALSE(PureIOC::findContract("contract-id-never-interned").has_value());
+
+    auto id = PureIOC::internContract("contract-id-found");
+    auto found = PureIOC::findContract("contract-id-found");
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(id, *found);
+}
+
+TEST(ContractId, NameRoundTrips) {
+    auto id = PureIOC::internContract("contract-id-name");
+    EXPECT_EQ("contract-id-name", PureIOC::contractName(id));
+}
+
+TEST(ContractId, ConcurrentInterningAgreesOnIds) {
+    constexpr int Threads = 4;
+    constexpr int Contracts = 500;
+    std::vector<std::vector<PureIOC::ContractId>> ids(Threads, std::vector<PureIOC::ContractId>(Contracts));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; ++t) {
+        threads.emplace_back([t, &ids] {
+            for (int i = 0; i < Contracts; ++i) {
+                const int index = (i + t * 97) % Contracts;
+                ids[t][index] = PureIOC::internContract("contract-id-concurrent-" + std::to_string(index));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (int i = 0; i < Contracts; ++i) {
+        const std::string name = "contract-id-concurrent-" + std::to_string(i);
+        for (int t = 1; t < Threads; ++t) {
+            EXPECT_EQ(ids[0][i], ids[t][i]);
+        }
+        EXPECT_EQ(ids[0][i], PureIOC::findContract(name));
+        EXPECT_EQ(name, PureIOC::contractName(ids[0][i]));
+    }
+}
+
+TEST(ContractId, ConcurrentInterningAssignsDenseIds) {
+    constexpr int Threads = 4;
+    constexpr int Contracts = 400;
+    const PureIOC::ContractId first = PureIOC::internContract("contract-id-dense-first");
+    std::vector<std::vector<PureIOC::ContractId>> ids(Threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; ++t) {
+        threads.emplace_back([t, &ids] {
+            for (int i = 0; i < Contracts; ++i) {
+                ids[t].push_back(PureIOC::internContract("contract-id-dense-" + std::to_string(t) + "-" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<std::uint32_t> values;
+    for (const auto &interned : ids) {
+        for (PureIOC::ContractId id : interned) {
+            values.push_back(id.value());
+        }
+    }
+    std::sort(values.begin(), values.end());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(first.value() + 1 + i, values[i]);
+    }
+}
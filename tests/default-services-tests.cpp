@@ -1,9 +1,18 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <memory>
+#include <memory_resource>
 #include <type_traits>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <container-manager.h>
 #include <internal/default-services.h>
+#include <service-entry.h>
+#include <service-slot.h>
 
 struct TestService {
     virtual ~TestService() = default;
@@ -144,3 +153,774 @@ TEST_F(DefaultServicesTest, UnregisterServiceWithContract) {
     auto serviceAfterUnregister = services.getService(typeid(TestService), "contract");
     ASSERT_FALSE(serviceAfterUnregister.has_value());
 }
+
+TEST(DefaultServicesShardedTest, UnregisterAllRemovesServicesWithOneChange) {
+    PureIOC::ContainerOptions options;
+    options.shards = 4;
+    PureIOC::internal::DefaultServices services(options);
+    auto instance = std::make_shared<TestServiceImpl>();
+    services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(instance));
+    services.registerConstant(typeid(TestService), "contract", std::make_any<std::shared_ptr<TestService>>(instance));
+    services.registerConstant(typeid(TestService), "kept", std::make_any<std::shared_ptr<TestService>>(instance));
+    const std::uint64_t generation = services.generation();
+
+    services.unregisterAll({PureIOC::ServiceKey{typeid(TestService), std::nullopt},
+                            PureIOC::ServiceKey{typeid(TestService), std::string("contract")},
+                            PureIOC::ServiceKey{typeid(TestService), std::string("never registered")}});
+
+    EXPECT_FALSE(services.getService(typeid(TestService)).has_value());
+    EXPECT_FALSE(services.getService(typeid(TestService), "contract").has_value());
+    EXPECT_TRUE(services.getService(typeid(TestService), "kept").has_value());
+    EXPECT_EQ(generation + 1, services.generation());
+}
+
+TEST_F(DefaultServicesTest, GetServiceBySlot) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(instance));
+
+    auto service = services.getService(PureIOC::typeSlot<TestService>(), typeid(TestService));
+    ASSERT_TRUE(service.has_value());
+    EXPECT_EQ(instance, std::any_cast<std::shared_ptr<TestService>>(*service));
+
+    auto another = services.getService(PureIOC::typeSlot<AnotherTestService>(), typeid(AnotherTestService));
+    EXPECT_FALSE(another.has_value());
+}
+
+TEST_F(DefaultServicesTest, GetLifetime) {
+    services.registerService(typeid(TestService), [] {
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    });
+    services.registerLazySingleton(typeid(TestService), "singleton", [] {
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    });
+    services.registerConstant(typeid(AnotherTestService),
+        std::make_any<std::shared_ptr<AnotherTestService>>(std::make_shared<AnotherTestServiceImpl>()));
+
+    EXPECT_EQ(PureIOC::ServiceLifetime::Transient, services.getLifetime(typeid(TestService)));
+    EXPECT_EQ(PureIOC::ServiceLifetime::LazySingleton, services.getLifetime(typeid(TestService), "singleton"));
+    EXPECT_EQ(PureIOC::ServiceLifetime::Constant, services.getLifetime(typeid(AnotherTestService)));
+    EXPECT_FALSE(services.getLifetime(typeid(AnotherTestService), "missing").has_value());
+}
+
+TEST_F(DefaultServicesTest, BorrowService) {
+    auto constant = std::make_shared<TestServiceImpl>();
+    int constructed = 0;
+    services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(constant));
+    services.registerLazySingleton(typeid(AnotherTestService), [&constructed] {
+        ++constructed;
+        return std::make_any<std::shared_ptr<AnotherTestService>>(std::make_shared<AnotherTestServiceImpl>());
+    });
+    services.registerService(typeid(TestService), "transient", [] {
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    });
+
+    const std::any *borrowed = services.borrowService(PureIOC::typeSlot<TestService>(), typeid(TestService), PureIOC::ContractId());
+    ASSERT_NE(nullptr, borrowed);
+    EXPECT_EQ(constant, std::any_cast<std::shared_ptr<TestService>>(*borrowed));
+
+    const std::any *singleton = services.borrowService(PureIOC::typeSlot<AnotherTestService>(), typeid(AnotherTestService), PureIOC::ContractId());
+    ASSERT_NE(nullptr, singleton);
+    EXPECT_EQ(singleton, services.borrowService(PureIOC::typeSlot<AnotherTestService>(), typeid(AnotherTestService), PureIOC::ContractId()));
+    EXPECT_EQ(1, constructed);
+
+    EXPECT_EQ(nullptr, services.borrowService(PureIOC::typeSlot<TestService>(), typeid(TestService), PureIOC::internContract("transient")));
+    EXPECT_EQ(nullptr, services.borrowService(PureIOC::typeSlot<TestService>(), typeid(TestService), PureIOC::internContract("missing")));
+}
+
+TEST_F(DefaultServicesTest, MissesFollowRegistrations) {
+    EXPECT_FALSE(services.getService(typeid(TestService)).has_value());
+    EXPECT_EQ(nullptr, services.borrowService(PureIOC::typeSlot<TestService>(), typeid(TestService), PureIOC::ContractId()));
+
+    for (int i = 0; i < 5000; ++i) {
+        services.registerConstant(typeid(TestService), "key-" + std::to_string(i),
+            std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>()));
+    }
+    for (int i = 0; i < 5000; i += 2) {
+        services.unregisterService(typeid(TestService), "key-" + std::to_string(i));
+    }
+
+    for (int i = 0; i < 5000; ++i) {
+        EXPECT_EQ(i % 2 == 1, services.getService(typeid(TestService), "key-" + std::to_string(i)).has_value()) << i;
+    }
+
+    services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>()));
+    EXPECT_TRUE(services.getService(typeid(TestService)).has_value());
+    services.unregisterService(typeid(TestService));
+    EXPECT_FALSE(services.getService(typeid(TestService)).has_value());
+}
+
+TEST_F(DefaultServicesTest, RegistrationAdvancesGeneration) {
+    const std::uint64_t before = services.generation();
+    services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>()));
+    const std::uint64_t registered = services.generation();
+    EXPECT_NE(before, registered);
+
+    services.unregisterService(typeid(TestService));
+    EXPECT_NE(registered, services.generation());
+}
+
+TEST_F(DefaultServicesTest, RegistrationLeavesOtherContainersGenerationAlone) {
+    const std::uint64_t global = PureIOC::servicesGeneration();
+    services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>()));
+
+    EXPECT_EQ(global, PureIOC::servicesGeneration());
+}
+
+TEST(DefaultServicesHierarchyTest, GenerationFollowsParentButNotChild) {
+    auto parent = std::make_shared<PureIOC::internal::DefaultServices>();
+    PureIOC::ContainerOptions options;
+    options.parent = parent;
+    auto child = std::make_shared<PureIOC::internal::DefaultServices>(options);
+
+    const std::uint64_t parent_before = parent->generation();
+    const std::uint64_t child_before = child->generation();
+    child->registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>()));
+    EXPECT_EQ(parent_before, parent->generation());
+    EXPECT_NE(child_before, child->generation());
+
+    const std::uint64_t child_registered = child->generation();
+    parent->registerConstant(typeid(AnotherTestService),
+        std::make_any<std::shared_ptr<AnotherTestService>>(std::make_shared<AnotherTestServiceImpl>()));
+    EXPECT_NE(child_registered, child->generation());
+}
+
+TEST_F(DefaultServicesTest, FreezeKeepsRegistrations) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(instance));
+    int factory_call_count = 0;
+    services.registerService(typeid(TestService), "transient", [&] {
+        factory_call_count++;
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    });
+    services.registerLazySingleton(typeid(AnotherTestService), "singleton", [] {
+        return std::make_any<std::shared_ptr<AnotherTestService>>(std::make_shared<AnotherTestServiceImpl>());
+    });
+
+    ASSERT_TRUE(services.freeze());
+
+    auto constant = services.getService(typeid(TestService));
+    ASSERT_TRUE(constant.has_value());
+    EXPECT_EQ(instance, std::any_cast<std::shared_ptr<TestService>>(*constant));
+
+    services.getService(typeid(TestService), "transient");
+    services.getService(typeid(TestService), "transient");
+    EXPECT_EQ(2, factory_call_count);
+
+    auto singleton1 = services.getService(typeid(AnotherTestService), "singleton");
+    auto singleton2 = services.getService(typeid(AnotherTestService), "singleton");
+    ASSERT_TRUE(singleton1.has_value());
+    EXPECT_EQ(std::any_cast<std::shared_ptr<AnotherTestService>>(*singleton1),
+        std::any_cast<std::shared_ptr<AnotherTestService>>(*singleton2));
+
+    EXPECT_FALSE(services.getService(typeid(AnotherTestService)).has_value());
+    EXPECT_FALSE(services.getService(typeid(TestService), "missing").has_value());
+    EXPECT_EQ(PureIOC::ServiceLifetime::Transient, services.getLifetime(typeid(TestService), "transient"));
+}
+
+TEST_F(DefaultServicesTest, FreezeRejectsRegistrationChanges) {
+    services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>()));
+    services.freeze();
+
+    EXPECT_FALSE(services.registerConstant(typeid(AnotherTestService),
+        std::make_any<std::shared_ptr<AnotherTestService>>(std::make_shared<AnotherTestServiceImpl>())));
+    EXPECT_FALSE(services.registerLazySingleton(typeid(AnotherTestService), [] {
+        return std::make_any<std::shared_ptr<AnotherTestService>>(std::make_shared<AnotherTestServiceImpl>());
+    }));
+
+    services.unregisterService(typeid(TestService));
+    EXPECT_TRUE(services.getService(typeid(TestService)).has_value());
+}
+
+TEST_F(DefaultServicesTest, FreezeKeepsConstructedSingleton) {
+    int factory_call_count = 0;
+    services.registerLazySingleton(typeid(TestService), [&] {
+        factory_call_count++;
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    });
+
+    auto before = services.getService(typeid(TestService));
+    services.freeze();
+    auto after = services.getService(typeid(TestService));
+
+    EXPECT_EQ(1, factory_call_count);
+    EXPECT_EQ(std::any_cast<std::shared_ptr<TestService>>(*before),
+        std::any_cast<std::shared_ptr<TestService>>(*after));
+}
+
+TEST_F(DefaultServicesTest, GetServiceByContractId) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    services.registerConstant(typeid(TestService), "interned", std::make_any<std::shared_ptr<TestService>>(instance));
+
+    auto service = services.getService(PureIOC::typeSlot<TestService>(), typeid(TestService),
+        PureIOC::internContract("interned"));
+    ASSERT_TRUE(service.has_value());
+    EXPECT_EQ(instance, std::any_cast<std::shared_ptr<TestService>>(*service));
+
+    auto uncontracted = services.getService(PureIOC::typeSlot<TestService>(), typeid(TestService), PureIOC::ContractId());
+    EXPECT_FALSE(uncontracted.has_value());
+}
+
+TEST_F(DefaultServicesTest, GetServiceByContractView) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    services.registerConstant(typeid(TestService), "viewed", std::make_any<std::shared_ptr<TestService>>(instance));
+
+    const std::string_view contract = "viewed";
+    auto service = services.getService(PureIOC::typeSlot<TestService>(), typeid(TestService), contract);
+    ASSERT_TRUE(service.has_value());
+    EXPECT_EQ(instance, std::any_cast<std::shared_ptr<TestService>>(*service));
+
+    auto missing = services.getService(PureIOC::typeSlot<TestService>(), typeid(TestService),
+        std::string_view("never-registered-view"));
+    EXPECT_FALSE(missing.has_value());
+}
+
+TEST_F(DefaultServicesTest, GetServicesResolvesEveryRequest) {
+    auto constant = std::make_shared<TestServiceImpl>();
+    services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(constant));
+    services.registerService(typeid(AnotherTestService), "batched", [] {
+        return std::make_any<std::shared_ptr<AnotherTestService>>(std::make_shared<AnotherTestServiceImpl>());
+    });
+
+    const PureIOC::ServiceRequest requests[] = {
+        {PureIOC::typeSlot<TestService>(), typeid(TestService), PureIOC::ContractId()},
+        {PureIOC::typeSlot<AnotherTestService>(), typeid(AnotherTestService), PureIOC::internContract("batched")},
+        {PureIOC::typeSlot<AnotherTestService>(), typeid(AnotherTestService), PureIOC::ContractId()},
+    };
+    std::optional<std::any> results[3];
+    services.getServices(requests, results, 3);
+
+    ASSERT_TRUE(results[0].has_value());
+    EXPECT_EQ(constant, std::any_cast<std::shared_ptr<TestService>>(*results[0]));
+    ASSERT_TRUE(results[1].has_value());
+    EXPECT_NE(nullptr, std::any_cast<std::shared_ptr<AnotherTestService>>(*results[1]));
+    EXPECT_FALSE(results[2].has_value());
+
+    services.freeze();
+    std::optional<std::any> frozen[3];
+    services.getServices(requests, frozen, 3);
+    EXPECT_TRUE(frozen[0].has_value());
+    EXPECT_TRUE(frozen[1].has_value());
+    EXPECT_FALSE(frozen[2].has_value());
+}
+
+TEST_F(DefaultServicesTest, KeyHoldsOneRegistration) {
+    ASSERT_TRUE(services.registerConstant(typeid(TestService),
+        std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>())));
+
+    EXPECT_FALSE(services.registerService(typeid(TestService), [] {
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    }));
+    EXPECT_FALSE(services.registerLazySingleton(typeid(TestService), [] {
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    }));
+    EXPECT_EQ(PureIOC::ServiceLifetime::Constant, services.getLifetime(typeid(TestService)));
+}
+
+TEST_F(DefaultServicesTest, ReregisterAfterUnregisterUsesNewEntry) {
+    services.registerLazySingleton(typeid(TestService), [] {
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    });
+    auto first = std::any_cast<std::shared_ptr<TestService>>(*services.getService(typeid(TestService)));
+
+    services.unregisterService(typeid(TestService));
+    services.registerLazySingleton(typeid(TestService), [] {
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    });
+    auto second = std::any_cast<std::shared_ptr<TestService>>(*services.getService(typeid(TestService)));
+
+    EXPECT_NE(first, second);
+}
+
+TEST_F(DefaultServicesTest, LazySingletonConstructedOnceAcrossThreads) {
+    std::atomic<int> factory_call_count{0};
+    services.registerLazySingleton(typeid(TestService), [&] {
+        factory_call_count++;
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    });
+
+    std::vector<std::shared_ptr<TestService>> resolved(8);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < resolved.size(); ++i) {
+        threads.emplace_back([&, i] {
+            for (int j = 0; j < 100; ++j) {
+                resolved[i] = std::any_cast<std::shared_ptr<TestService>>(*services.getService(typeid(TestService)));
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(1, factory_call_count.load());
+    for (const auto &service : resolved) {
+        EXPECT_EQ(resolved.front(), service);
+    }
+}
+
+TEST(DefaultServicesCopyOnWriteTest, RegisterGetAndUnregister) {
+    PureIOC::ContainerOptions options;
+    options.copyOnWrite = true;
+    PureIOC::internal::DefaultServices services(options);
+
+    auto constant = std::make_shared<TestServiceImpl>();
+    EXPECT_TRUE(services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(constant)));
+    EXPECT_TRUE(services.registerLazySingleton(typeid(TestService), "singleton", [] {
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    }));
+    EXPECT_FALSE(services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(constant)));
+
+    EXPECT_EQ(constant, std::any_cast<std::shared_ptr<TestService>>(*services.getService(typeid(TestService))));
+    auto first = std::any_cast<std::shared_ptr<TestService>>(*services.getService(typeid(TestService), "singleton"));
+    auto second = std::any_cast<std::shared_ptr<TestService>>(*services.getService(typeid(TestService), "singleton"));
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(PureIOC::ServiceLifetime::LazySingleton, services.getLifetime(typeid(TestService), "singleton"));
+
+    services.unregisterService(typeid(TestService));
+    EXPECT_FALSE(services.getService(typeid(TestService)).has_value());
+    EXPECT_TRUE(services.getService(typeid(TestService), "singleton").has_value());
+}
+
+TEST(DefaultServicesCopyOnWriteTest, ReadersSeeServiceWhileWriterRegisters) {
+    PureIOC::ContainerOptions options;
+    options.copyOnWrite = true;
+    PureIOC::internal::DefaultServices services(options);
+
+    auto constant = std::make_shared<TestServiceImpl>();
+    services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(constant));
+
+    std::atomic<bool> done{false};
+    std::atomic<int> misses{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                auto service = services.getService(typeid(TestService));
+                if (!service || std::any_cast<std::shared_ptr<TestService>>(*service) != constant) {
+                    ++misses;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        services.registerService(typeid(AnotherTestService), "tenant-" + std::to_string(i), [] {
+            return std::make_any<std::shared_ptr<AnotherTestService>>(std::make_shared<AnotherTestServiceImpl>());
+        });
+    }
+    done = true;
+    for (auto &t : readers) {
+        t.join();
+    }
+
+    EXPECT_EQ(0, misses.load());
+    EXPECT_TRUE(services.getService(typeid(AnotherTestService), "tenant-199").has_value());
+}
+
+TEST(DefaultServicesShardedTest, ConcurrentRegistrationsAcrossShards) {
+    PureIOC::ContainerOptions options;
+    options.shards = 8;
+    PureIOC::internal::DefaultServices services(options);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&services, t] {
+            for (int i = 0; i < 100; ++i) {
+                services.registerService(typeid(TestService), "tenant-" + std::to_string(t) + "-" + std::to_string(i), [] {
+                    return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+                });
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (int t = 0; t < 4; ++t) {
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_TRUE(services.getService(typeid(TestService), "tenant-" + std::to_string(t) + "-" + std::to_string(i)).has_value());
+        }
+    }
+}
+
+TEST(DefaultServicesShardedTest, ConcurrentRegistrationsEachAdvanceGeneration) {
+    PureIOC::ContainerOptions options;
+    options.shards = 8;
+    PureIOC::internal::DefaultServices services(options);
+    const std::uint64_t before = services.generation();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&services, t] {
+            for (int i = 0; i < 50; ++i) {
+                const std::string contract = "versioned-" + std::to_string(t) + "-" + std::to_string(i);
+                services.registerConstant(typeid(TestService), contract, std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>()));
+                services.unregisterService(typeid(TestService), contract);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(before + 400, services.generation());
+}
+
+TEST(DefaultServicesShardedTest, GetServicesAcrossShards) {
+    PureIOC::ContainerOptions options;
+    options.shards = 4;
+    PureIOC::internal::DefaultServices services(options);
+
+    std::vector<PureIOC::ServiceRequest> requests;
+    for (int i = 0; i < 20; ++i) {
+        const std::string contract = "batched-" + std::to_string(i);
+        if (i % 2 == 0) {
+            services.registerConstant(typeid(TestService), contract, std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>()));
+        }
+        requests.push_back({PureIOC::typeSlot<TestService>(), typeid(TestService), PureIOC::internContract(contract)});
+    }
+
+    std::vector<std::optional<std::any>> results(requests.size());
+    services.getServices(requests.data(), results.data(), requests.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(i % 2 == 0, results[i].has_value());
+    }
+}
+
+TEST(DefaultServicesCopyOnWriteTest, ReadersSeeBatchAcrossShardsWhollyOrNotAtAll) {
+    PureIOC::ContainerOptions options;
+    options.shards = 4;
+    options.copyOnWrite = true;
+    PureIOC::internal::DefaultServices services(options);
+
+    constexpr std::size_t Rounds = 32;
+    constexpr std::size_t Count = 8;
+    auto contract = [](std::size_t round, std::size_t i) {
+        return "batch-" + std::to_string(round) + "-" + std::to_string(i);
+    };
+    std::vector<PureIOC::ServiceRequest> requests;
+    for (std::size_t round = 0; round < Rounds; ++round) {
+        for (std::size_t i = 0; i < Count; ++i) {
+            requests.push_back(PureIOC::ServiceRequest{PureIOC::typeSlot<TestService>(), typeid(TestService),
+                PureIOC::internContract(contract(round, i))});
+        }
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::thread reader([&] {
+        std::vector<std::optional<std::any>> results(requests.size());
+        while (!done.load()) {
+            services.getServices(requests.data(), results.data(), requests.size());
+            for (std::size_t round = 0; round < Rounds; ++round) {
+                const auto begin = results.begin() + static_cast<std::ptrdiff_t>(round * Count);
+                const auto found = std::count_if(begin, begin + Count, [](const auto &result) {
+                    return result.has_value();
+                });
+                if (found != 0 && found != static_cast<std::ptrdiff_t>(Count)) {
+                    ++torn;
+                }
+            }
+        }
+    });
+
+    auto constant = std::make_shared<TestServiceImpl>();
+    for (std::size_t round = 0; round < Rounds; ++round) {
+        std::vector<PureIOC::ServiceRegistration> batch;
+        for (std::size_t i = 0; i < Count; ++i) {
+            batch.push_back(PureIOC::ServiceRegistration{typeid(TestService), contract(round, i),
+                PureIOC::ServiceLifetime::Constant, nullptr, std::make_any<std::shared_ptr<TestService>>(constant), nullptr});
+        }
+        EXPECT_EQ(Count, services.registerBatch(std::move(batch)));
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(0, torn.load());
+}
+
+TEST(DefaultServicesCopyOnWriteTest, ListsEntriesFromSnapshots) {
+    PureIOC::ContainerOptions options;
+    options.shards = 4;
+    options.copyOnWrite = true;
+    PureIOC::internal::DefaultServices services(options);
+
+    auto constant = std::make_shared<TestServiceImpl>();
+    for (int i = 0; i < 8; ++i) {
+        services.registerConstant(typeid(TestService), "listed-" + std::to_string(i), std::make_any<std::shared_ptr<TestService>>(constant));
+    }
+    services.unregisterService(typeid(TestService), "listed-0");
+
+    EXPECT_EQ(7u, services.getEntries().size());
+}
+
+TEST(DefaultServicesShardedTest, FreezeCompilesEveryShard) {
+    PureIOC::ContainerOptions options;
+    options.shards = 4;
+    options.copyOnWrite = true;
+    PureIOC::internal::DefaultServices services(options);
+
+    auto constant = std::make_shared<TestServiceImpl>();
+    services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(constant));
+    for (int i = 0; i < 16; ++i) {
+        services.registerConstant(typeid(TestService), "contract-" + std::to_string(i), std::make_any<std::shared_ptr<TestService>>(constant));
+    }
+
+    EXPECT_TRUE(services.freeze());
+    EXPECT_FALSE(services.registerConstant(typeid(AnotherTestService),
+        std::make_any<std::shared_ptr<AnotherTestService>>(std::make_shared<AnotherTestServiceImpl>())));
+
+    EXPECT_EQ(constant, std::any_cast<std::shared_ptr<TestService>>(*services.getService(typeid(TestService))));
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_TRUE(services.getService(typeid(TestService), "contract-" + std::to_string(i)).has_value());
+    }
+}
+
+TEST(DefaultServicesHierarchyTest, ChildInheritsAndOverridesParent) {
+    auto parent = std::make_shared<PureIOC::internal::DefaultServices>();
+    auto inherited = std::make_shared<TestServiceImpl>();
+    parent->registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(inherited));
+    parent->registerConstant(typeid(TestService), "contract", std::make_any<std::shared_ptr<TestService>>(inherited));
+    parent->registerConstant(typeid(AnotherTestService),
+        std::make_any<std::shared_ptr<AnotherTestService>>(std::make_shared<AnotherTestServiceImpl>()));
+
+    PureIOC::ContainerOptions options;
+    options.parent = parent;
+    PureIOC::internal::DefaultServices child(options);
+    auto overridden = std::make_shared<AnotherTestServiceImpl>();
+    child.registerConstant(typeid(AnotherTestService), std::make_any<std::shared_ptr<AnotherTestService>>(overridden));
+
+    EXPECT_EQ(inherited, std::any_cast<std::shared_ptr<TestService>>(*child.getService(typeid(TestService))));
+    EXPECT_EQ(inherited, std::any_cast<std::shared_ptr<TestService>>(*child.getService(typeid(TestService), "contract")));
+    EXPECT_EQ(overridden, std::any_cast<std::shared_ptr<AnotherTestService>>(*child.getService(typeid(AnotherTestService))));
+    EXPECT_EQ(PureIOC::ServiceLifetime::Constant, child.getLifetime(typeid(TestService)));
+    EXPECT_FALSE(child.getService(typeid(TestService), "missing").has_value());
+
+    const PureIOC::ServiceRequest requests[] = {
+        {PureIOC::typeSlot<TestService>(), typeid(TestService), PureIOC::internContract("contract")},
+        {PureIOC::typeSlot<AnotherTestService>(), typeid(AnotherTestService), PureIOC::ContractId()},
+    };
+    std::optional<std::any> results[2];
+    child.getServices(requests, results, 2);
+    EXPECT_EQ(inherited, std::any_cast<std::shared_ptr<TestService>>(*results[0]));
+    EXPECT_EQ(overridden, std::any_cast<std::shared_ptr<AnotherTestService>>(*results[1]));
+}
+
+TEST(DefaultServicesHierarchyTest, GrandchildSharesRootSingleton) {
+    auto root = std::make_shared<PureIOC::internal::DefaultServices>();
+    int constructed = 0;
+    root->registerLazySingleton(typeid(TestService), [&constructed] {
+        ++constructed;
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    });
+
+    PureIOC::ContainerOptions options;
+    options.parent = root;
+    auto child = std::make_shared<PureIOC::internal::DefaultServices>(options);
+    options.parent = child;
+    PureIOC::internal::DefaultServices grandchild(options);
+
+    auto fromGrandchild = std::any_cast<std::shared_ptr<TestService>>(*grandchild.getService(typeid(TestService)));
+    auto fromRoot = std::any_cast<std::shared_ptr<TestService>>(*root->getService(typeid(TestService)));
+    EXPECT_EQ(fromRoot, fromGrandchild);
+    EXPECT_EQ(fromRoot, std::any_cast<std::shared_ptr<TestService>>(*grandchild.getService(typeid(TestService))));
+    EXPECT_EQ(1, constructed);
+}
+
+TEST(DefaultServicesHierarchyTest, ParentChangesInvalidateChildCache) {
+    auto parent = std::make_shared<PureIOC::internal::DefaultServices>();
+    auto first = std::make_shared<TestServiceImpl>();
+    parent->registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(first));
+
+    PureIOC::ContainerOptions options;
+    options.parent = parent;
+    PureIOC::internal::DefaultServices child(options);
+    EXPECT_EQ(first, std::any_cast<std::shared_ptr<TestService>>(*child.getService(typeid(TestService))));
+
+    parent->unregisterService(typeid(TestService));
+    EXPECT_FALSE(child.getService(typeid(TestService)).has_value());
+
+    auto second = std::make_shared<TestServiceImpl>();
+    parent->registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(second));
+    EXPECT_EQ(second, std::any_cast<std::shared_ptr<TestService>>(*child.getService(typeid(TestService))));
+}
+
+namespace {
+class MockParent : public PureIOC::IServices {
+public:
+    MOCK_METHOD(std::optional<std::any>, getService, (const std::type_index &), (override));
+    MOCK_METHOD(std::optional<std::any>, getService, (const std::type_index &, const std::string &), (override));
+    MOCK_METHOD(std::optional<std::any>, getService, (std::size_t, const std::type_index &, PureIOC::ContractId), (override));
+    MOCK_METHOD(std::uint64_t, generation, (), (noexcept, override));
+    MOCK_METHOD(std::shared_ptr<PureIOC::ServiceEntry>, getEntry, (std::size_t, const std::type_index &, PureIOC::ContractId), (override));
+    MOCK_METHOD(bool, registerService, (const std::type_index &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerService, (const std::type_index &, const std::string &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerLazySingleton, (const std::type_index &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerLazySingleton, (const std::type_index &, const std::string &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerConstant, (const std::type_index &, std::any), (override));
+    MOCK_METHOD(bool, registerConstant, (const std::type_index &, const std::string &, std::any), (override));
+    MOCK_METHOD(void, unregisterService, (const std::type_index &), (override));
+    MOCK_METHOD(void, unregisterService, (const std::type_index &, const std::string &), (override));
+};
+}
+
+TEST(DefaultServicesHierarchyTest, CachesMissesThroughParent) {
+    auto parent = std::make_shared<::testing::NiceMock<MockParent>>();
+    ON_CALL(*parent, generation()).WillByDefault(::testing::Return(7));
+    EXPECT_CALL(*parent, getEntry(::testing::_, ::testing::_, ::testing::_)).WillOnce(::testing::Return(nullptr));
+    EXPECT_CALL(*parent, getService(::testing::_, ::testing::_, ::testing::An<PureIOC::ContractId>())).Times(0);
+
+    PureIOC::ContainerOptions options;
+    options.parent = parent;
+    PureIOC::internal::DefaultServices child(options);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_FALSE(child.getService(typeid(TestService)).has_value());
+        EXPECT_FALSE(child.getLifetime(typeid(TestService)).has_value());
+    }
+}
+
+TEST(DefaultServicesHierarchyTest, ResolvesInheritedEntryWithoutAskingParentAgain) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    auto entry = std::make_shared<PureIOC::ServiceEntry>(PureIOC::ServiceLifetime::Constant, nullptr, std::make_any<std::shared_ptr<TestService>>(instance));
+    auto parent = std::make_shared<::testing::NiceMock<MockParent>>();
+    ON_CALL(*parent, generation()).WillByDefault(::testing::Return(7));
+    EXPECT_CALL(*parent, getEntry(::testing::_, ::testing::_, ::testing::_)).WillOnce(::testing::Return(entry));
+    EXPECT_CALL(*parent, getService(::testing::_, ::testing::_, ::testing::An<PureIOC::ContractId>())).Times(0);
+
+    PureIOC::ContainerOptions options;
+    options.parent = parent;
+    PureIOC::internal::DefaultServices child(options);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(instance, std::any_cast<std::shared_ptr<TestService>>(*child.getService(typeid(TestService))));
+    }
+}
+
+TEST(DefaultServicesHierarchyTest, AsksParentWithoutGenerationEveryTime) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    auto parent = std::make_shared<::testing::NiceMock<MockParent>>();
+    EXPECT_CALL(*parent, getEntry(::testing::_, ::testing::_, ::testing::_)).Times(2).WillRepeatedly(::testing::Return(nullptr));
+    EXPECT_CALL(*parent, getService(::testing::_, ::testing::_, ::testing::An<PureIOC::ContractId>()))
+        .Times(2)
+        .WillRepeatedly(::testing::Return(std::make_any<std::shared_ptr<TestService>>(instance)));
+
+    PureIOC::ContainerOptions options;
+    options.parent = parent;
+    PureIOC::internal::DefaultServices child(options);
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(instance, std::any_cast<std::shared_ptr<TestService>>(*child.getService(typeid(TestService))));
+    }
+}
+
+TEST(DefaultServicesHierarchyTest, ConcurrentInheritedLookupsAgree) {
+    auto parent = std::make_shared<PureIOC::internal::DefaultServices>();
+    for (int i = 0; i < 100; ++i) {
+        if (i % 2 == 0) {
+            parent->registerConstant(typeid(TestService), "inherited-" + std::to_string(i), std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>()));
+        }
+    }
+
+    PureIOC::ContainerOptions options;
+    options.parent = parent;
+    PureIOC::internal::DefaultServices child(options);
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&child, &mismatches, t] {
+            for (int round = 0; round < 3; ++round) {
+                for (int i = 0; i < 100; ++i) {
+                    const int index = (i + t * 31) % 100;
+                    if (child.getService(typeid(TestService), "inherited-" + std::to_string(index)).has_value() != (index % 2 == 0)) {
+                        ++mismatches;
+                    }
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(0, mismatches.load());
+}
+
+namespace {
+class CountingResource final : public std::pmr::memory_resource {
+public:
+    int allocations = 0;
+    int outstanding = 0;
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        ++outstanding;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        --outstanding;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+}
+
+TEST(DefaultServicesResourceTest, RegistryAllocatesFromResource) {
+    CountingResource counting;
+    std::pmr::memory_resource *previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    {
+        PureIOC::ContainerOptions options;
+        options.resource = &counting;
+        options.shards = 2;
+        options.copyOnWrite = true;
+        PureIOC::internal::DefaultServices services(options);
+
+        auto instance = std::make_shared<TestServiceImpl>();
+        services.registerConstant(typeid(TestService), std::make_any<std::shared_ptr<TestService>>(instance));
+        services.registerConstant(typeid(TestService), "pmr", std::make_any<std::shared_ptr<TestService>>(instance));
+        EXPECT_TRUE(services.freeze());
+
+        EXPECT_EQ(instance, std::any_cast<std::shared_ptr<TestService>>(*services.getService(typeid(TestService), "pmr")));
+        EXPECT_GT(counting.allocations, 0);
+    }
+    std::pmr::set_default_resource(previous);
+
+    EXPECT_EQ(0, counting.outstanding);
+}
+
+TEST(DefaultServicesResourceTest, ConcurrentRegistrationsShareSynchronizedArena) {
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::synchronized_pool_resource pool(&arena);
+    PureIOC::ContainerOptions options;
+    options.resource = &pool;
+    options.shards = 4;
+    auto services = std::make_shared<PureIOC::internal::DefaultServices>(options);
+    PureIOC::ContainerOptions childOptions;
+    childOptions.resource = &pool;
+    childOptions.parent = services;
+    PureIOC::internal::DefaultServices child(childOptions);
+
+    constexpr int Threads = 4;
+    constexpr int PerThread = 1024;
+    auto instance = std::make_shared<TestServiceImpl>();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < PerThread; ++i) {
+                const std::string contract = std::to_string(t) + "-" + std::to_string(i);
+                services->registerConstant(typeid(TestService), contract, std::make_any<std::shared_ptr<TestService>>(instance));
+                child.getService(typeid(TestService), contract);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 0; t < Threads; ++t) {
+        for (int i = 0; i < PerThread; ++i) {
+            EXPECT_TRUE(services->getService(typeid(TestService), std::to_string(t) + "-" + std::to_string(i)).has_value());
+        }
+    }
+}
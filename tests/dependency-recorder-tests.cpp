@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <typeindex>
+
+#include <auto-wiring.h>
+#include <container-manager.h>
+#include <dependency-recorder.h>
+#include <locator.h>
+#include <locator-mutable.h>
+#include <service-handle.h>
+
+namespace {
+struct Settings {};
+
+struct Clock {};
+
+struct Repository {
+    std::shared_ptr<Clock> clock;
+};
+
+struct Handler {
+    Handler(std::shared_ptr<Repository> repository, std::shared_ptr<Clock> clock)
+        : repository(std::move(repository)), clock(std::move(clock)) {}
+
+    std::shared_ptr<Repository> repository;
+    std::shared_ptr<Clock> clock;
+};
+
+std::size_t indexOf(const PureIOC::DependencyGraph &graph, const std::type_index &type) {
+    for (std::size_t i = 0; i < graph.nodes.size(); ++i) {
+        if (graph.nodes[i].type == type) {
+            return i;
+        }
+    }
+
+    return graph.nodes.size();
+}
+
+bool dependsOn(const PureIOC::DependencyGraph &graph, const std::type_index &from, const std::type_index &to) {
+    const std::vector<std::size_t> &dependencies = graph.nodes.at(indexOf(graph, from)).dependencies;
+    return std::find(dependencies.begin(), dependencies.end(), indexOf(graph, to)) != dependencies.end();
+}
+
+class DependencyRecorderTest : public ::testing::Test {
+protected:
+    std::shared_ptr<PureIOC::DependencyRecorder> recorder = std::make_shared<PureIOC::DependencyRecorder>();
+
+    void SetUp() override {
+        PureIOC::ContainerOptions options;
+        options.recorder = recorder;
+        PureIOC::registerContainer(options);
+
+        PureIOC::registerConstant<Settings, Settings>(std::make_shared<Settings>());
+        PureIOC::registerLazySingleton<Clock>([] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            return std::make_shared<Clock>();
+        });
+        PureIOC::registerLazySingleton<Repository>([] {
+            PureIOC::getService<Settings>();
+            auto repository = std::make_shared<Repository>();
+            repository->clock = PureIOC::getService<Clock>();
+            return repository;
+        });
+    }
+
+    void TearDown() override {
+        PureIOC::registerContainer(nullptr);
+    }
+};
+}
+
+TEST_F(DependencyRecorderTest, RecordsNestedResolutions) {
+    ASSERT_TRUE((PureIOC::registerType<Handler, Handler, Repository, Clock>()));
+
+    PureIOC::getService<Handler>();
+    PureIOC::getService<Handler>();
+
+    PureIOC::DependencyGraph graph = recorder->graph();
+    ASSERT_EQ(4u, graph.nodes.size());
+    EXPECT_TRUE(dependsOn(graph, typeid(Handler), typeid(Repository)));
+    EXPECT_TRUE(dependsOn(graph, typeid(Handler), typeid(Clock)));
+    EXPECT_TRUE(dependsOn(graph, typeid(Repository), typeid(Clock)));
+    EXPECT_TRUE(dependsOn(graph, typeid(Repository), typeid(Settings)));
+    EXPECT_TRUE(graph.nodes[indexOf(graph, typeid(Clock))].dependencies.empty());
+
+    const PureIOC::DependencyNode &handler = graph.nodes[indexOf(graph, typeid(Handler))];
+    const PureIOC::DependencyNode &repository = graph.nodes[indexOf(graph, typeid(Repository))];
+    const PureIOC::DependencyNode &clock = graph.nodes[indexOf(graph, typeid(Clock))];
+    EXPECT_EQ(2u, handler.constructions);
+    EXPECT_EQ(1u, repository.constructions);
+    EXPECT_EQ(1u, clock.constructions);
+    EXPECT_EQ(0u, graph.nodes[indexOf(graph, typeid(Settings))].constructions);
+    EXPECT_GE(clock.inclusive, std::chrono::milliseconds(2));
+}
+
+TEST_F(DependencyRecorderTest, CriticalPathFollowsTheSlowestChain) {
+    PureIOC::getService<Repository>();
+
+    PureIOC::DependencyGraph graph = recorder->graph();
+    std::vector<std::size_t> path = graph.criticalPath();
+    ASSERT_EQ(2u, path.size());
+    EXPECT_EQ(indexOf(graph, typeid(Repository)), path[0]);
+    EXPECT_EQ(indexOf(graph, typeid(Clock)), path[1]);
+    EXPECT_GE(graph.criticalPathDuration(), std::chrono::milliseconds(2));
+
+    const PureIOC::DependencyNode &repository = graph.nodes[path[0]];
+    const PureIOC::DependencyNode &clock = graph.nodes[path[1]];
+    EXPECT_GE(repository.inclusive, clock.inclusive);
+    EXPECT_LT(repository.exclusive, clock.exclusive);
+}
+
+TEST_F(DependencyRecorderTest, RendersDotAndJson) {
+    PureIOC::registerService<Handler>("named", [] { return std::make_shared<Handler>(PureIOC::getService<Repository>(), nullptr); });
+    PureIOC::getService<Handler>("named");
+
+    PureIOC::DependencyGraph graph = recorder->graph();
+    const std::string dot = graph.toDot();
+    EXPECT_EQ(0u, dot.find("digraph services {"));
+    EXPECT_NE(std::string::npos, dot.find("Repository"));
+    EXPECT_NE(std::string::npos, dot.find("Handler (named)"));
+    const std::string edge = "n" + std::to_string(indexOf(graph, typeid(Repository))) + " -> n" + std::to_string(indexOf(graph, typeid(Clock))) + " [color=red]";
+    EXPECT_NE(std::string::npos, dot.find(edge));
+
+    const std::string json = graph.toJson();
+    EXPECT_EQ('{', json.front());
+    EXPECT_EQ('}', json.back());
+    EXPECT_NE(std::string::npos, json.find("\"contract\":\"named\""));
+    EXPECT_NE(std::string::npos, json.find("\"criticalPath\":[" + std::to_string(indexOf(graph, typeid(Handler)))));
+}
+
+TEST_F(DependencyRecorderTest, ResolutionsOutsideFactoriesAreNotDependencies) {
+    PureIOC::getService<Settings>();
+    PureIOC::getService<Clock>();
+
+    PureIOC::DependencyGraph graph = recorder->graph();
+    ASSERT_EQ(1u, graph.nodes.size());
+    EXPECT_EQ(std::type_index(typeid(Clock)), graph.nodes[0].type);
+
+    recorder->clear();
+    EXPECT_TRUE(recorder->graph().nodes.empty());
+    EXPECT_TRUE(recorder->graph().criticalPath().empty());
+}
+
+TEST_F(DependencyRecorderTest, JsonEscapesControlCharactersInContracts) {
+    PureIOC::registerService<Handler>("tab\there\nnext\x01", [] { return std::make_shared<Handler>(nullptr, nullptr); });
+    PureIOC::getService<Handler>("tab\there\nnext\x01");
+
+    PureIOC::DependencyGraph graph = recorder->graph();
+    const std::string json = graph.toJson();
+    EXPECT_NE(std::string::npos, json.find("\"contract\":\"tab\\there\\nnext\\u0001\""));
+    EXPECT_EQ(std::string::npos, json.find('\n'));
+    EXPECT_EQ(std::string::npos, json.find('\x01'));
+
+}
+
+TEST_F(DependencyRecorderTest, DotLabelsBreakLinesAndReplaceControlCharacters) {
+    PureIOC::registerService<Handler>("tab\there\nnext\x01\"quoted\"", [] { return std::make_shared<Handler>(nullptr, nullptr); });
+    PureIOC::getService<Handler>("tab\there\nnext\x01\"quoted\"");
+
+    const std::string dot = recorder->graph().toDot();
+    EXPECT_NE(std::string::npos, dot.find("(tab?here\\nnext?\\\"quoted\\\")"));
+    EXPECT_EQ(std::string::npos, dot.find("\\u"));
+    EXPECT_EQ(std::string::npos, dot.find('\t'));
+    EXPECT_EQ(std::string::npos, dot.find('\x01'));
+}
+
+TEST(DependencyGraphTest, CriticalPathOfLongChain) {
+    constexpr std::size_t Length = 200000;
+    PureIOC::DependencyGraph graph;
+    graph.nodes.reserve(Length);
+    for (std::size_t i = 0; i < Length; ++i) {
+        graph.nodes.push_back(PureIOC::DependencyNode{typeid(int), PureIOC::ContractId(), 1, std::chrono::nanoseconds(1), std::chrono::nanoseconds(1), {}});
+        if (i + 1 < Length) {
+            graph.nodes.back().dependencies.push_back(i + 1);
+        }
+    }
+    graph.nodes.back().dependencies.push_back(0);
+
+    std::vector<std::size_t> path = graph.criticalPath();
+    ASSERT_EQ(Length, path.size());
+    EXPECT_EQ(0u, path.front());
+    EXPECT_EQ(Length - 1, path.back());
+    EXPECT_EQ(std::chrono::nanoseconds(Length), graph.criticalPathDuration());
+}
+
+TEST_F(DependencyRecorderTest, ResolutionsThroughBoundHandlesAreDependencies) {
+    auto clock = std::make_shared<PureIOC::ServiceHandle<Clock>>();
+    clock->get();
+    PureIOC::registerService<Handler>([clock] { return std::make_shared<Handler>(nullptr, clock->get()); });
+    recorder->clear();
+
+    PureIOC::getService<Handler>();
+
+    PureIOC::DependencyGraph graph = recorder->graph();
+    EXPECT_TRUE(dependsOn(graph, typeid(Handler), typeid(Clock)));
+}
+
+TEST_F(DependencyRecorderTest, AutoWiredDependenciesAreRecordedAfterClear) {
+    ASSERT_TRUE((PureIOC::registerType<Handler, Handler, Repository, Clock>()));
+    PureIOC::getService<Handler>();
+    recorder->clear();
+
+    PureIOC::getService<Handler>();
+
+    PureIOC::DependencyGraph graph = recorder->graph();
+    EXPECT_TRUE(dependsOn(graph, typeid(Handler), typeid(Repository)));
+    EXPECT_TRUE(dependsOn(graph, typeid(Handler), typeid(Clock)));
+    EXPECT_EQ(1u, graph.nodes[indexOf(graph, typeid(Handler))].constructions);
+}
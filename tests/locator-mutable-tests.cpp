@@ -1,5 +1,6 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <memory_resource>
 
 #include <container-manager.h>
 #include <locator-mutable.h>
@@ -17,6 +18,7 @@ public:
     MOCK_METHOD(bool, registerConstant, (const std::type_index &, const std::string &, std::any), (override));
     MOCK_METHOD(void, unregisterService, (const std::type_index &), (override));
     MOCK_METHOD(void, unregisterService, (const std::type_index &, const std::string &), (override));
+    MOCK_METHOD(bool, freeze, (), (override));
 };
 
 class DummyLogger final : public PureIOC::ILogger {
@@ -168,6 +170,17 @@ TEST(LocatorMutable, UnregisterWithContractForwardsToContainer) {
     PureIOC::unregister(std::type_index(typeid(int)), "delta");
 }
 
+TEST(LocatorMutable, FreezeForwardsToContainer) {
+    auto mock = std::make_shared<MockServices>();
+    PureIOC::registerContainer(mock);
+
+    EXPECT_CALL(*mock, freeze())
+        .Times(1)
+        .WillOnce(testing::Return(true));
+
+    EXPECT_TRUE(PureIOC::freeze());
+}
+
 TEST(LocatorMutable, CleanupReplacesCurrentContainer) {
     auto mock = std::make_shared<MockServices>();
     PureIOC::registerContainer(mock);
@@ -237,6 +250,39 @@ TEST(LocatorMutable, TemplateRegisterLazySingletonWithContract) {
     })));
 }
 
+TEST(LocatorMutable, TemplateRegisterServiceStoresCallable) {
+    auto mock = std::make_shared<MockServices>();
+    PureIOC::registerContainer(mock);
+
+    std::function<std::any()> stored;
+    EXPECT_CALL(*mock, registerService(testing::Eq(std::type_index(typeid(ITestService))), testing::_))
+        .WillOnce([&stored](const std::type_index &, std::function<std::any()> factory) {
+            stored = std::move(factory);
+            return true;
+        });
+
+    auto instance = std::make_shared<TestService>();
+    EXPECT_TRUE((PureIOC::registerService<ITestService, TestService>([instance] {
+        return instance;
+    })));
+
+    ASSERT_TRUE(stored);
+    EXPECT_EQ(instance, std::any_cast<std::shared_ptr<ITestService>>(stored()));
+}
+
+TEST(LocatorMutable, TemplateRegisterLazySingletonWithoutImplementationType) {
+    auto mock = std::make_shared<MockServices>();
+    PureIOC::registerContainer(mock);
+
+    EXPECT_CALL(*mock,
+        registerLazySingleton(testing::Eq(std::type_index(typeid(ITestService))), testing::StrEq("test"), testing::_))
+        .WillOnce(testing::Return(true));
+
+    EXPECT_TRUE(PureIOC::registerLazySingleton<ITestService>("test", []() -> std::shared_ptr<ITestService> {
+        return std::make_shared<TestService>();
+    }));
+}
+
 TEST(LocatorMutable, TemplateRegisterConstant) {
     auto mock = std::make_shared<MockServices>();
     PureIOC::registerContainer(mock);
@@ -303,3 +349,21 @@ TEST(LocatorMutable, TemplateUnregisterWithContract) {
 
     PureIOC::unregister<ITestService>("test");
 }
+
+TEST(LocatorMutable, AllocatingFactoryConstructsInResource) {
+    struct Config {
+        explicit Config(int value) : value(value) {}
+        int value;
+    };
+
+    std::byte buffer[256];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    auto factory = PureIOC::allocatingFactory<Config>(&arena, 42);
+
+    std::shared_ptr<Config> config = factory();
+    EXPECT_EQ(42, config->value);
+    EXPECT_GE(reinterpret_cast<std::byte *>(config.get()), buffer);
+    EXPECT_LT(reinterpret_cast<std::byte *>(config.get()), buffer + sizeof(buffer));
+
+    EXPECT_EQ(7, PureIOC::allocateService<Config>(&arena, 7)->value);
+}
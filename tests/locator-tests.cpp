@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <container-manager.h>
 #include <services-interface.h>
@@ -11,6 +12,9 @@ class MockServices final : public PureIOC::IServices {
 public:
     MOCK_METHOD(std::optional<std::any>, getService, (const std::type_index &), (override));
     MOCK_METHOD(std::optional<std::any>, getService, (const std::type_index &, const std::string &), (override));
+    MOCK_METHOD(std::optional<PureIOC::ServiceLifetime>, getLifetime, (const std::type_index &), (override));
+    MOCK_METHOD(std::optional<PureIOC::ServiceLifetime>, getLifetime, (const std::type_index &, const std::string &), (override));
+    MOCK_METHOD(const std::any *, borrowService, (std::size_t, const std::type_index &, PureIOC::ContractId), (override));
     MOCK_METHOD(bool, registerService, (const std::type_index &, std::function<std::any()>), (override));
     MOCK_METHOD(bool, registerService, (const std::type_index &, const std::string &, std::function<std::any()>), (override));
     MOCK_METHOD(bool, registerLazySingleton, (const std::type_index &, std::function<std::any()>), (override));
@@ -26,6 +30,12 @@ struct TestService {
 };
 
 struct TestServiceImpl : public TestService {};
+
+struct OtherService {
+    virtual ~OtherService() = default;
+};
+
+struct OtherServiceImpl : public OtherService {};
 }
 
 class LocatorTest : public ::testing::Test {
@@ -93,3 +103,139 @@ TEST_F(LocatorTest, GetNonExistentServiceReturnsNull) {
     auto service = PureIOC::getService<TestService>();
     EXPECT_EQ(service, nullptr);
 }
+
+TEST_F(LocatorTest, GetCachedServiceReusesConstant) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    EXPECT_CALL(*mockServices, getService(std::type_index(typeid(TestService))))
+        .WillOnce(testing::Return(std::make_any<std::shared_ptr<TestService>>(instance)));
+    EXPECT_CALL(*mockServices, getLifetime(std::type_index(typeid(TestService))))
+        .WillOnce(testing::Return(PureIOC::ServiceLifetime::Constant));
+
+    auto first = PureIOC::getCachedService<TestService>();
+    auto second = PureIOC::getCachedService<TestService>();
+    EXPECT_EQ(instance, first);
+    EXPECT_EQ(instance, second);
+}
+
+TEST_F(LocatorTest, GetCachedServiceResolvesAgainAfterInvalidation) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    EXPECT_CALL(*mockServices, getService(std::type_index(typeid(TestService))))
+        .Times(2)
+        .WillRepeatedly(testing::Return(std::make_any<std::shared_ptr<TestService>>(instance)));
+    EXPECT_CALL(*mockServices, getLifetime(std::type_index(typeid(TestService))))
+        .Times(2)
+        .WillRepeatedly(testing::Return(PureIOC::ServiceLifetime::LazySingleton));
+
+    PureIOC::getCachedService<TestService>();
+    PureIOC::invalidateServices();
+    auto service = PureIOC::getCachedService<TestService>();
+    EXPECT_EQ(instance, service);
+}
+
+TEST_F(LocatorTest, GetCachedServiceDoesNotCacheTransient) {
+    EXPECT_CALL(*mockServices, getService(std::type_index(typeid(TestService))))
+        .Times(2)
+        .WillRepeatedly([] {
+            return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+        });
+    EXPECT_CALL(*mockServices, getLifetime(std::type_index(typeid(TestService))))
+        .Times(2)
+        .WillRepeatedly(testing::Return(PureIOC::ServiceLifetime::Transient));
+
+    auto first = PureIOC::getCachedService<TestService>();
+    auto second = PureIOC::getCachedService<TestService>();
+    EXPECT_NE(first, second);
+}
+
+TEST_F(LocatorTest, GetCachedServiceWithContractReusesConstant) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    const std::string contract = "contract";
+    EXPECT_CALL(*mockServices, getService(std::type_index(typeid(TestService)), contract))
+        .WillOnce(testing::Return(std::make_any<std::shared_ptr<TestService>>(instance)));
+    EXPECT_CALL(*mockServices, getLifetime(std::type_index(typeid(TestService)), contract))
+        .WillOnce(testing::Return(PureIOC::ServiceLifetime::Constant));
+
+    EXPECT_EQ(instance, PureIOC::getCachedService<TestService>(contract));
+    EXPECT_EQ(instance, PureIOC::getCachedService<TestService>(contract));
+}
+
+TEST_F(LocatorTest, GetServiceByTemplateWithContractId) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    const auto contract = PureIOC::internContract("contract");
+    EXPECT_CALL(*mockServices, getService(std::type_index(typeid(TestService)), std::string("contract")))
+        .WillOnce(testing::Return(std::make_any<std::shared_ptr<TestService>>(instance)));
+
+    auto service = PureIOC::getService<TestService>(contract);
+    EXPECT_EQ(instance, service);
+}
+
+TEST_F(LocatorTest, GetServiceByTemplateWithContractView) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    EXPECT_CALL(*mockServices, getService(std::type_index(typeid(TestService)), std::string("view")))
+        .WillOnce(testing::Return(std::make_any<std::shared_ptr<TestService>>(instance)));
+
+    const std::string_view contract = "view";
+    EXPECT_EQ(instance, PureIOC::getService<TestService>(contract));
+}
+
+TEST_F(LocatorTest, BorrowReusesReferenceUntilInvalidation) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    const std::any stored = std::make_any<std::shared_ptr<TestService>>(instance);
+    EXPECT_CALL(*mockServices, borrowService(testing::_, std::type_index(typeid(TestService)), PureIOC::ContractId()))
+        .Times(2)
+        .WillRepeatedly(testing::Return(&stored));
+
+    auto first = PureIOC::borrow<TestService>();
+    auto second = PureIOC::borrow<TestService>();
+    EXPECT_EQ(instance.get(), first.get());
+    EXPECT_EQ(instance.get(), second.get());
+    EXPECT_TRUE(first.valid());
+
+    PureIOC::invalidateServices();
+    EXPECT_FALSE(first.valid());
+    EXPECT_EQ(instance.get(), PureIOC::borrow<TestService>().get());
+}
+
+TEST_F(LocatorTest, BorrowWithContractId) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    const std::any stored = std::make_any<std::shared_ptr<TestService>>(instance);
+    const auto contract = PureIOC::internContract("borrowed");
+    EXPECT_CALL(*mockServices, borrowService(testing::_, std::type_index(typeid(TestService)), contract))
+        .WillOnce(testing::Return(&stored));
+
+    EXPECT_EQ(instance.get(), PureIOC::borrow<TestService>(contract).get());
+}
+
+TEST_F(LocatorTest, BorrowUnsupportedServiceIsEmpty) {
+    EXPECT_CALL(*mockServices, borrowService(testing::_, std::type_index(typeid(TestService)), PureIOC::ContractId()))
+        .WillOnce(testing::Return(nullptr));
+
+    auto service = PureIOC::borrow<TestService>();
+    EXPECT_FALSE(service);
+    EXPECT_FALSE(service.valid());
+}
+
+TEST_F(LocatorTest, ResolveAllReturnsEveryService) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    EXPECT_CALL(*mockServices, getService(std::type_index(typeid(TestService))))
+        .WillOnce(testing::Return(std::make_any<std::shared_ptr<TestService>>(instance)));
+    EXPECT_CALL(*mockServices, getService(std::type_index(typeid(OtherService))))
+        .WillOnce(testing::Return(std::nullopt));
+
+    auto [service, other] = PureIOC::resolveAll<TestService, OtherService>();
+    EXPECT_EQ(instance, service);
+    EXPECT_EQ(nullptr, other);
+}
+
+TEST_F(LocatorTest, ResolveAllWithContractIds) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    auto other = std::make_shared<OtherServiceImpl>();
+    EXPECT_CALL(*mockServices, getService(std::type_index(typeid(TestService)), std::string("first")))
+        .WillOnce(testing::Return(std::make_any<std::shared_ptr<TestService>>(instance)));
+    EXPECT_CALL(*mockServices, getService(std::type_index(typeid(OtherService))))
+        .WillOnce(testing::Return(std::make_any<std::shared_ptr<OtherService>>(other)));
+
+    auto services = PureIOC::resolveAll<TestService, OtherService>(PureIOC::internContract("first"), PureIOC::ContractId());
+    EXPECT_EQ(instance, std::get<0>(services));
+    EXPECT_EQ(other, std::get<1>(services));
+}
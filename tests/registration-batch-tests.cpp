@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <memory>
+#include <string>
+
+#include <container-manager.h>
+#include <container-options.h>
+#include <locator.h>
+#include <locator-mutable.h>
+#include <registration-batch.h>
+#include <scope.h>
+
+namespace {
+struct TestService {
+    virtual ~TestService() = default;
+};
+
+struct TestServiceImpl : public TestService {};
+
+struct AnotherTestService {
+    virtual ~AnotherTestService() = default;
+};
+
+struct AnotherTestServiceImpl : public AnotherTestService {};
+
+class MockServices final : public PureIOC::IServices {
+public:
+    MOCK_METHOD(std::optional<std::any>, getService, (const std::type_index &), (override));
+    MOCK_METHOD(std::optional<std::any>, getService, (const std::type_index &, const std::string &), (override));
+    MOCK_METHOD(bool, registerService, (const std::type_index &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerService, (const std::type_index &, const std::string &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerLazySingleton, (const std::type_index &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerLazySingleton, (const std::type_index &, const std::string &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerConstant, (const std::type_index &, std::any), (override));
+    MOCK_METHOD(bool, registerConstant, (const std::type_index &, const std::string &, std::any), (override));
+    MOCK_METHOD(void, unregisterService, (const std::type_index &), (override));
+    MOCK_METHOD(void, unregisterService, (const std::type_index &, const std::string &), (override));
+};
+
+class MockLogger final : public PureIOC::ILogger {
+public:
+    MOCK_METHOD(void, verbose, (std::string_view, std::string_view), (override));
+    MOCK_METHOD(void, info, (std::string_view, std::string_view), (override));
+    MOCK_METHOD(void, warn, (std::string_view, std::string_view), (override));
+    MOCK_METHOD(void, warn, (std::string_view, std::string_view, const std::exception_ptr &), (override));
+    MOCK_METHOD(void, warn, (std::string_view, const std::exception_ptr &), (override));
+    MOCK_METHOD(void, error, (std::string_view, std::string_view), (override));
+    MOCK_METHOD(void, error, (std::string_view, std::string_view, const std::exception_ptr &), (override));
+    MOCK_METHOD(void, error, (std::string_view, const std::exception_ptr &), (override));
+    MOCK_METHOD(void, fatal, (std::string_view, std::string_view), (override));
+    MOCK_METHOD(void, fatal, (std::string_view, std::string_view, const std::exception_ptr &), (override));
+    MOCK_METHOD(void, fatal, (std::string_view, const std::exception_ptr &), (override));
+    MOCK_METHOD(void, debug, (std::string_view, std::string_view), (override));
+};
+
+class RegistrationBatchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        PureIOC::registerContainer(PureIOC::ContainerOptions());
+    }
+
+    void TearDown() override {
+        PureIOC::registerContainer(nullptr);
+    }
+};
+}
+
+TEST_F(RegistrationBatchTest, CommitRegistersEveryLifetime) {
+    auto constant = std::make_shared<TestServiceImpl>();
+    int factory_call_count = 0;
+
+    PureIOC::RegistrationBatch batch;
+    batch.reserve(4)
+        .addConstant<TestService>(constant)
+        .addService<TestService, TestServiceImpl>("transient", [&] {
+            factory_call_count++;
+            return std::make_shared<TestServiceImpl>();
+        })
+        .addLazySingleton<AnotherTestService, AnotherTestServiceImpl>([] { return std::make_shared<AnotherTestServiceImpl>(); })
+        .addScoped<AnotherTestService>("scoped", [](PureIOC::Scope &scope) { return scope.make<AnotherTestServiceImpl>(); });
+    EXPECT_EQ(4u, batch.size());
+
+    EXPECT_EQ(4u, batch.commit());
+    EXPECT_EQ(0u, batch.size());
+
+    EXPECT_EQ(constant, PureIOC::getService<TestService>());
+    EXPECT_NE(nullptr, PureIOC::getService<TestService>("transient"));
+    EXPECT_EQ(1, factory_call_count);
+    EXPECT_EQ(PureIOC::getService<AnotherTestService>(), PureIOC::getService<AnotherTestService>());
+
+    PureIOC::Scope scope;
+    EXPECT_NE(nullptr, scope.getService<AnotherTestService>(PureIOC::internContract("scoped")));
+}
+
+TEST_F(RegistrationBatchTest, CommitSkipsDuplicatesAndWarnsOnce) {
+    auto logger = std::make_shared<MockLogger>();
+    PureIOC::registerConstant<PureIOC::ILogger, MockLogger>(logger);
+    auto existing = std::make_shared<TestServiceImpl>();
+    PureIOC::registerConstant<TestService, TestServiceImpl>(existing);
+
+    EXPECT_CALL(*logger, warn(testing::A<std::string_view>(), testing::Matcher<std::string_view>(testing::HasSubstr("2 services")))).Times(1);
+
+    PureIOC::RegistrationBatch batch;
+    batch.addConstant<TestService>(std::make_shared<TestServiceImpl>())
+        .addConstant<AnotherTestService>(std::make_shared<AnotherTestServiceImpl>())
+        .addConstant<AnotherTestService>(std::make_shared<AnotherTestServiceImpl>());
+
+    EXPECT_EQ(1u, batch.commit());
+    EXPECT_EQ(existing, PureIOC::getService<TestService>());
+    EXPECT_NE(nullptr, PureIOC::getService<AnotherTestService>());
+}
+
+TEST_F(RegistrationBatchTest, CommitInvalidatesCachedResolutionsOnce) {
+    const std::uint64_t generation = PureIOC::servicesGeneration();
+
+    PureIOC::RegistrationBatch batch;
+    batch.addConstant<TestService>(std::make_shared<TestServiceImpl>())
+        .addConstant<AnotherTestService>(std::make_shared<AnotherTestServiceImpl>());
+    batch.commit();
+
+    EXPECT_EQ(generation + 1, PureIOC::servicesGeneration());
+}
+
+TEST_F(RegistrationBatchTest, CommitIsRejectedByFrozenContainer) {
+    PureIOC::freeze();
+
+    PureIOC::RegistrationBatch batch;
+    batch.addConstant<TestService>(std::make_shared<TestServiceImpl>());
+
+    EXPECT_EQ(0u, batch.commit());
+    EXPECT_EQ(nullptr, PureIOC::getService<TestService>());
+}
+
+TEST_F(RegistrationBatchTest, CommitFallsBackToSingleRegistrations) {
+    auto mock_services = std::make_shared<MockServices>();
+    PureIOC::registerContainer(mock_services);
+
+    EXPECT_CALL(*mock_services, registerConstant(testing::Eq(std::type_index(typeid(TestService))), testing::_))
+        .WillOnce(testing::Return(true));
+    EXPECT_CALL(*mock_services, registerLazySingleton(testing::Eq(std::type_index(typeid(AnotherTestService))), "singleton", testing::_))
+        .WillOnce(testing::Return(false));
+
+    PureIOC::RegistrationBatch batch;
+    batch.addConstant<TestService>(std::make_shared<TestServiceImpl>())
+        .addLazySingleton<AnotherTestService, AnotherTestServiceImpl>("singleton", [] { return std::make_shared<AnotherTestServiceImpl>(); });
+
+    EXPECT_EQ(1u, batch.commit());
+}
+
+TEST_F(RegistrationBatchTest, CommitAllRejectsWholeBatchOnDuplicate) {
+    auto existing = std::make_shared<AnotherTestServiceImpl>();
+    PureIOC::registerConstant<AnotherTestService, AnotherTestServiceImpl>(existing);
+    const std::uint64_t generation = PureIOC::servicesGeneration();
+
+    PureIOC::RegistrationBatch batch;
+    batch.addConstant<TestService>(std::make_shared<TestServiceImpl>())
+        .addConstant<AnotherTestService>(std::make_shared<AnotherTestServiceImpl>());
+
+    EXPECT_FALSE(batch.commitAll());
+    EXPECT_EQ(0u, batch.size());
+    EXPECT_EQ(nullptr, PureIOC::getService<TestService>());
+    EXPECT_EQ(existing, PureIOC::getService<AnotherTestService>());
+    EXPECT_EQ(generation, PureIOC::servicesGeneration());
+
+    batch.addConstant<TestService>(std::make_shared<TestServiceImpl>())
+        .addConstant<TestService>(std::make_shared<TestServiceImpl>());
+    EXPECT_FALSE(batch.commitAll());
+    EXPECT_EQ(nullptr, PureIOC::getService<TestService>());
+
+    batch.addConstant<TestService>(std::make_shared<TestServiceImpl>())
+        .addConstant<AnotherTestService>("other", std::make_shared<AnotherTestServiceImpl>());
+    EXPECT_TRUE(batch.commitAll());
+    EXPECT_NE(nullptr, PureIOC::getService<TestService>());
+    EXPECT_NE(nullptr, PureIOC::getService<AnotherTestService>("other"));
+}
+
+TEST_F(RegistrationBatchTest, CommitAllUndoesSingleRegistrations) {
+    auto mock_services = std::make_shared<MockServices>();
+    PureIOC::registerContainer(mock_services);
+
+    EXPECT_CALL(*mock_services, registerConstant(testing::Eq(std::type_index(typeid(TestService))), testing::_))
+        .WillOnce(testing::Return(true));
+    EXPECT_CALL(*mock_services, registerLazySingleton(testing::Eq(std::type_index(typeid(AnotherTestService))), "singleton", testing::_))
+        .WillOnce(testing::Return(false));
+    EXPECT_CALL(*mock_services, unregisterService(testing::Eq(std::type_index(typeid(TestService))))).Times(1);
+
+    PureIOC::RegistrationBatch batch;
+    batch.addConstant<TestService>(std::make_shared<TestServiceImpl>())
+        .addLazySingleton<AnotherTestService, AnotherTestServiceImpl>("singleton", [] { return std::make_shared<AnotherTestServiceImpl>(); });
+
+    EXPECT_FALSE(batch.commitAll());
+}
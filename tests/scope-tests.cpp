@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+#include <container-manager.h>
+#include <locator.h>
+#include <locator-mutable.h>
+#include <scope.h>
+
+namespace {
+struct RequestContext {
+    virtual ~RequestContext() = default;
+    int id = 0;
+};
+
+struct RequestContextImpl : public RequestContext {};
+
+struct RequestLogger {
+    explicit RequestLogger(std::shared_ptr<RequestContext> context)
+        : context(std::move(context)) {}
+
+    std::shared_ptr<RequestContext> context;
+};
+
+struct Settings {
+    int value = 7;
+};
+
+/**
+ * @brief A memory resource that counts the allocations forwarded to the heap.
+ */
+class CountingResource final : public std::pmr::memory_resource {
+public:
+    int allocations = 0;
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+class ScopeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        PureIOC::registerContainer(nullptr);
+        PureIOC::registerScoped<RequestContext, RequestContextImpl>([](PureIOC::Scope &scope) {
+            return scope.make<RequestContextImpl>();
+        });
+    }
+
+    void TearDown() override {
+        PureIOC::registerContainer(nullptr);
+    }
+};
+} // namespace
+
+TEST_F(ScopeTest, ScopedServiceCreatedOncePerScope) {
+    PureIOC::Scope first;
+    PureIOC::Scope second;
+
+    auto a = first.getService<RequestContext>();
+    ASSERT_NE(nullptr, a);
+    EXPECT_EQ(a, first.getService<RequestContext>());
+    EXPECT_NE(a, second.getService<RequestContext>());
+}
+
+TEST_F(ScopeTest, ScopedServiceReleasedWithScope) {
+    std::weak_ptr<RequestContext> weak;
+    {
+        PureIOC::Scope scope;
+        weak = scope.getService<RequestContext>();
+        EXPECT_FALSE(weak.expired());
+    }
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST_F(ScopeTest, ScopedServiceNotResolvedOutsideScope) {
+    EXPECT_EQ(nullptr, PureIOC::getService<RequestContext>());
+    EXPECT_EQ(PureIOC::ServiceLifetime::Scoped, PureIOC::getContainer()->getLifetime(typeid(RequestContext)));
+}
+
+TEST_F(ScopeTest, ScopedFactoriesShareScopedDependencies) {
+    PureIOC::registerScoped<RequestLogger>("request", [](PureIOC::Scope &scope) {
+        return scope.make<RequestLogger>(scope.getService<RequestContext>());
+    });
+
+    PureIOC::Scope scope;
+    auto logger = scope.getService<RequestLogger>(PureIOC::internContract("request"));
+    ASSERT_NE(nullptr, logger);
+    EXPECT_EQ(scope.getService<RequestContext>(), logger->context);
+}
+
+TEST_F(ScopeTest, OtherServicesResolveThroughScope) {
+    auto settings = std::make_shared<Settings>();
+    PureIOC::registerConstant<Settings, Settings>(settings);
+
+    PureIOC::Scope scope;
+    EXPECT_EQ(settings, scope.getService<Settings>());
+    EXPECT_EQ(nullptr, scope.getService<Settings>(PureIOC::internContract("missing")));
+}
+
+TEST_F(ScopeTest, SmallScopeDoesNotAllocateFromHeap) {
+    CountingResource counting;
+    std::pmr::memory_resource *previous = std::pmr::set_default_resource(&counting);
+    {
+        PureIOC::Scope scope;
+        ASSERT_NE(nullptr, scope.getService<RequestContext>());
+    }
+    std::pmr::set_default_resource(previous);
+
+    EXPECT_EQ(0, counting.allocations);
+}
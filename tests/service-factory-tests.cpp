@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#include <container-manager.h>
+#include <container-options.h>
+#include <locator.h>
+#include <locator-mutable.h>
+#include <service-factory.h>
+
+namespace {
+struct TestService {
+    virtual ~TestService() = default;
+};
+
+struct TestServiceImpl : public TestService {
+    int value = 0;
+};
+
+class ServiceFactoryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        PureIOC::registerContainer(PureIOC::ContainerOptions());
+    }
+
+    void TearDown() override {
+        PureIOC::registerContainer(nullptr);
+    }
+};
+}
+
+TEST_F(ServiceFactoryTest, SmallCallableIsStoredInline) {
+    const std::uint64_t fallbacks = PureIOC::ServiceFactory::heapFallbacks();
+    int a = 1, b = 2, c = 3;
+    PureIOC::ServiceFactory factory([a, b, c, p = &a]() -> std::any { return *p + b + c; });
+
+    EXPECT_TRUE(factory.isInline());
+    EXPECT_EQ(6, std::any_cast<int>(factory()));
+    EXPECT_EQ(fallbacks, PureIOC::ServiceFactory::heapFallbacks());
+}
+
+TEST_F(ServiceFactoryTest, OversizedCallableFallsBackToHeap) {
+    const std::uint64_t fallbacks = PureIOC::ServiceFactory::heapFallbacks();
+    std::array<int, 32> values{};
+    values[31] = 7;
+    PureIOC::ServiceFactory factory([values]() -> std::any { return values[31]; });
+
+    EXPECT_FALSE(factory.isInline());
+    EXPECT_EQ(fallbacks + 1, PureIOC::ServiceFactory::heapFallbacks());
+
+    PureIOC::ServiceFactory moved(std::move(factory));
+    EXPECT_FALSE(factory);
+    EXPECT_EQ(7, std::any_cast<int>(moved()));
+}
+
+TEST_F(ServiceFactoryTest, AcceptsMoveOnlyCallables) {
+    auto owned = std::make_unique<int>(5);
+    PureIOC::ServiceFactory factory([owned = std::move(owned)]() -> std::any { return *owned; });
+
+    PureIOC::ServiceFactory target;
+    target = std::move(factory);
+    EXPECT_TRUE(target);
+    EXPECT_EQ(5, std::any_cast<int>(target()));
+}
+
+TEST_F(ServiceFactoryTest, EmptyFunctionYieldsEmptyFactory) {
+    EXPECT_FALSE(PureIOC::ServiceFactory(std::function<std::any()>()));
+    EXPECT_FALSE(PureIOC::ServiceFactory(nullptr));
+    EXPECT_TRUE(PureIOC::ServiceFactory(std::function<std::any()>([] { return std::any(1); })));
+}
+
+TEST_F(ServiceFactoryTest, CallingEmptyFactoryThrows) {
+    PureIOC::ServiceFactory empty;
+    EXPECT_THROW(empty(), std::bad_function_call);
+
+    std::shared_ptr<PureIOC::IServices> container = PureIOC::getContainer();
+    ASSERT_TRUE(container->registerService(typeid(TestService), std::function<std::any()>()));
+    EXPECT_THROW(container->getService(typeid(TestService)), std::bad_function_call);
+}
+
+TEST_F(ServiceFactoryTest, RejectsMutableCallables) {
+    auto counting = [count = 0]() mutable -> std::any { return ++count; };
+    auto constant = []() -> std::any { return 1; };
+    EXPECT_FALSE((std::is_constructible_v<PureIOC::ServiceFactory, decltype(counting)>));
+    EXPECT_TRUE((std::is_constructible_v<PureIOC::ServiceFactory, decltype(constant)>));
+}
+
+TEST_F(ServiceFactoryTest, MutableFactoriesRunOnACopyForEachCall) {
+    ASSERT_TRUE((PureIOC::registerService<TestService, TestServiceImpl>([count = 0]() mutable {
+        auto service = std::make_shared<TestServiceImpl>();
+        service->value = ++count;
+        return service;
+    })));
+    std::shared_ptr<PureIOC::IServices> container = PureIOC::getContainer();
+    ASSERT_TRUE(container->registerService(typeid(int), std::function<std::any()>([count = 0]() mutable -> std::any { return ++count; })));
+
+    for (int i = 0; i < 2; ++i) {
+        auto service = std::static_pointer_cast<TestServiceImpl>(PureIOC::getService<TestService>());
+        ASSERT_NE(nullptr, service);
+        EXPECT_EQ(1, service->value);
+        EXPECT_EQ(1, std::any_cast<int>(*container->getService(typeid(int))));
+    }
+}
+
+TEST_F(ServiceFactoryTest, TemplateRegistrationKeepsCapturesInline) {
+    const std::uint64_t fallbacks = PureIOC::ServiceFactory::heapFallbacks();
+    int a = 1, b = 2, c = 3, d = 4;
+    const bool registered = PureIOC::registerService<TestService, TestServiceImpl>([a, b, c, d] {
+        auto service = std::make_shared<TestServiceImpl>();
+        service->value = a + b + c + d;
+        return service;
+    });
+    ASSERT_TRUE(registered);
+
+    auto service = std::static_pointer_cast<TestServiceImpl>(PureIOC::getService<TestService>());
+    ASSERT_NE(nullptr, service);
+    EXPECT_EQ(10, service->value);
+    EXPECT_EQ(fallbacks, PureIOC::ServiceFactory::heapFallbacks());
+}
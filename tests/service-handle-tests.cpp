@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <container-manager.h>
+#include <locator-mutable.h>
+#include <service-handle.h>
+
+namespace {
+struct TestService {
+    virtual ~TestService() = default;
+};
+
+struct TestServiceImpl : public TestService {};
+
+class MockServices final : public PureIOC::IServices {
+public:
+    MOCK_METHOD(std::optional<std::any>, getService, (const std::type_index &), (override));
+    MOCK_METHOD(std::optional<std::any>, getService, (const std::type_index &, const std::string &), (override));
+    MOCK_METHOD(bool, registerService, (const std::type_index &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerService, (const std::type_index &, const std::string &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerLazySingleton, (const std::type_index &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerLazySingleton, (const std::type_index &, const std::string &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerConstant, (const std::type_index &, std::any), (override));
+    MOCK_METHOD(bool, registerConstant, (const std::type_index &, const std::string &, std::any), (override));
+    MOCK_METHOD(void, unregisterService, (const std::type_index &), (override));
+    MOCK_METHOD(void, unregisterService, (const std::type_index &, const std::string &), (override));
+};
+
+class MockEntryServices final : public PureIOC::IServices {
+public:
+    MOCK_METHOD(std::optional<std::any>, getService, (const std::type_index &), (override));
+    MOCK_METHOD(std::optional<std::any>, getService, (const std::type_index &, const std::string &), (override));
+    MOCK_METHOD(bool, registerService, (const std::type_index &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerService, (const std::type_index &, const std::string &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerLazySingleton, (const std::type_index &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerLazySingleton, (const std::type_index &, const std::string &, std::function<std::any()>), (override));
+    MOCK_METHOD(bool, registerConstant, (const std::type_index &, std::any), (override));
+    MOCK_METHOD(bool, registerConstant, (const std::type_index &, const std::string &, std::any), (override));
+    MOCK_METHOD(void, unregisterService, (const std::type_index &), (override));
+    MOCK_METHOD(void, unregisterService, (const std::type_index &, const std::string &), (override));
+    MOCK_METHOD(std::uint64_t, generation, (), (noexcept, override));
+    MOCK_METHOD(std::shared_ptr<PureIOC::ServiceEntry>, getEntry, (std::size_t, const std::type_index &, PureIOC::ContractId), (override));
+};
+
+class ServiceHandleTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        PureIOC::registerContainer(nullptr);
+    }
+
+    void TearDown() override {
+        PureIOC::registerContainer(nullptr);
+    }
+};
+} // namespace
+
+TEST(ServiceEntryTest, ConstantIsPublishedOnConstruction) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    PureIOC::ServiceEntry entry(PureIOC::ServiceLifetime::Constant, nullptr, std::make_any<std::shared_ptr<TestService>>(instance));
+
+    ASSERT_NE(nullptr, entry.peek());
+    EXPECT_EQ(entry.peek(), entry.borrow());
+    EXPECT_EQ(instance, std::any_cast<std::shared_ptr<TestService>>(entry.resolve()));
+}
+
+TEST(ServiceEntryTest, LazySingletonIsPublishedOnFirstResolve) {
+    int calls = 0;
+    PureIOC::ServiceEntry entry(PureIOC::ServiceLifetime::LazySingleton, [&calls] {
+        ++calls;
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    }, std::any());
+
+    EXPECT_EQ(nullptr, entry.peek());
+    auto first = std::any_cast<std::shared_ptr<TestService>>(entry.resolve());
+    EXPECT_NE(nullptr, entry.peek());
+    EXPECT_EQ(first, std::any_cast<std::shared_ptr<TestService>>(entry.resolve()));
+    EXPECT_EQ(1, calls);
+}
+
+TEST(ServiceEntryTest, TransientIsNeverPublished) {
+    PureIOC::ServiceEntry entry(PureIOC::ServiceLifetime::Transient, [] {
+        return std::make_any<std::shared_ptr<TestService>>(std::make_shared<TestServiceImpl>());
+    }, std::any());
+
+    auto first = std::any_cast<std::shared_ptr<TestService>>(entry.resolve());
+    auto second = std::any_cast<std::shared_ptr<TestService>>(entry.resolve());
+    EXPECT_NE(first, second);
+    EXPECT_EQ(nullptr, entry.peek());
+    EXPECT_EQ(nullptr, entry.borrow());
+}
+
+TEST_F(ServiceHandleTest, ResolvesConstant) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    PureIOC::registerConstant<TestService, TestServiceImpl>(instance);
+
+    auto handle = PureIOC::getServiceHandle<TestService>();
+    EXPECT_EQ(instance, handle.get());
+    EXPECT_EQ(instance, handle());
+}
+
+TEST_F(ServiceHandleTest, ResolvesTransientWithContract) {
+    const auto contract = PureIOC::internContract("handle");
+    PureIOC::registerService<TestService, TestServiceImpl>("handle", [] {
+        return std::make_shared<TestServiceImpl>();
+    });
+
+    PureIOC::ServiceHandle<TestService> handle(contract);
+    auto first = handle.get();
+    auto second = handle.get();
+    ASSERT_NE(nullptr, first);
+    EXPECT_NE(first, second);
+}
+
+TEST_F(ServiceHandleTest, FollowsReregistration) {
+    auto first = std::make_shared<TestServiceImpl>();
+    PureIOC::registerConstant<TestService, TestServiceImpl>(first);
+
+    auto handle = PureIOC::getServiceHandle<TestService>();
+    EXPECT_EQ(first, handle.get());
+
+    PureIOC::unregister<TestService>();
+    EXPECT_EQ(nullptr, handle.get());
+
+    auto second = std::make_shared<TestServiceImpl>();
+    PureIOC::registerConstant<TestService, TestServiceImpl>(second);
+    EXPECT_EQ(second, handle.get());
+}
+
+TEST_F(ServiceHandleTest, FallsBackToGetServiceWithoutEntries) {
+    auto mock = std::make_shared<MockServices>();
+    PureIOC::registerContainer(mock);
+
+    auto instance = std::make_shared<TestServiceImpl>();
+    EXPECT_CALL(*mock, getService(std::type_index(typeid(TestService))))
+        .Times(2)
+        .WillRepeatedly(testing::Return(std::make_any<std::shared_ptr<TestService>>(instance)));
+
+    auto handle = PureIOC::getServiceHandle<TestService>();
+    EXPECT_EQ(instance, handle.get());
+    EXPECT_EQ(instance, handle.get());
+}
+
+TEST_F(ServiceHandleTest, RecordsMissUntilGenerationChanges) {
+    auto mock = std::make_shared<MockServices>();
+    PureIOC::registerContainer(mock);
+
+    auto instance = std::make_shared<TestServiceImpl>();
+    EXPECT_CALL(*mock, getService(std::type_index(typeid(TestService))))
+        .WillOnce(testing::Return(std::nullopt))
+        .WillOnce(testing::Return(std::make_any<std::shared_ptr<TestService>>(instance)));
+
+    auto handle = PureIOC::getServiceHandle<TestService>();
+    EXPECT_EQ(nullptr, handle.get());
+    EXPECT_EQ(nullptr, handle.get());
+    EXPECT_EQ(nullptr, handle.get());
+
+    PureIOC::invalidateServices();
+    EXPECT_EQ(instance, handle.get());
+}
+
+TEST_F(ServiceHandleTest, FindsServiceRegisteredAfterMiss) {
+    auto handle = PureIOC::getServiceHandle<TestService>();
+    EXPECT_EQ(nullptr, handle.get());
+    EXPECT_EQ(nullptr, handle.get());
+
+    auto instance = std::make_shared<TestServiceImpl>();
+    PureIOC::registerConstant<TestService, TestServiceImpl>(instance);
+    EXPECT_EQ(instance, handle.get());
+}
+
+TEST_F(ServiceHandleTest, BoundHandleDoesNotAskContainer) {
+    auto mock = std::make_shared<MockEntryServices>();
+    PureIOC::registerContainer(mock);
+
+    auto instance = std::make_shared<TestServiceImpl>();
+    auto entry = std::make_shared<PureIOC::ServiceEntry>(PureIOC::ServiceLifetime::Constant, nullptr, std::make_any<std::shared_ptr<TestService>>(instance));
+    EXPECT_CALL(*mock, generation()).Times(2).WillRepeatedly(testing::Return(1));
+    EXPECT_CALL(*mock, getEntry(testing::_, std::type_index(typeid(TestService)), PureIOC::ContractId())).Times(2).WillRepeatedly(testing::Return(entry));
+
+    auto handle = PureIOC::getServiceHandle<TestService>();
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(instance, handle.get());
+    }
+
+    PureIOC::invalidateServices();
+    EXPECT_EQ(instance, handle.get());
+    EXPECT_EQ(instance, handle.get());
+}
+
+TEST_F(ServiceHandleTest, FollowsRegistrationInAnotherContainer) {
+    auto instance = std::make_shared<TestServiceImpl>();
+    PureIOC::registerConstant<TestService, TestServiceImpl>(instance);
+    auto handle = PureIOC::getServiceHandle<TestService>();
+    EXPECT_EQ(instance, handle.get());
+
+    std::shared_ptr<PureIOC::IServices> other = PureIOC::makeContainer(PureIOC::ContainerOptions{});
+    other->registerConstant(typeid(int), std::make_any<std::shared_ptr<int>>(std::make_shared<int>(1)));
+    EXPECT_EQ(instance, handle.get());
+}
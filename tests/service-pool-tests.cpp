@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include <container-manager.h>
+#include <container-options.h>
+#include <locator.h>
+#include <locator-mutable.h>
+#include <service-pool.h>
+
+namespace {
+struct Buffer {
+    static inline int live = 0;
+    int used = 0;
+
+    Buffer() {
+        ++live;
+    }
+
+    virtual ~Buffer() {
+        --live;
+    }
+};
+
+class ServicePoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Buffer::live = 0;
+        PureIOC::registerContainer(PureIOC::ContainerOptions());
+    }
+
+    void TearDown() override {
+        PureIOC::registerContainer(nullptr);
+    }
+};
+}
+
+TEST_F(ServicePoolTest, RecyclesReleasedInstance) {
+    int resets = 0;
+    PureIOC::ServicePool<Buffer> pool([] { return std::make_unique<Buffer>(); }, [&resets](Buffer &buffer) {
+        ++resets;
+        buffer.used = 0;
+    });
+
+    Buffer *first = nullptr;
+    {
+        auto buffer = pool.acquire();
+        buffer->used = 42;
+        first = buffer.get();
+    }
+    EXPECT_EQ(1, resets);
+
+    auto again = pool.acquire();
+    EXPECT_EQ(first, again.get());
+    EXPECT_EQ(0, again->used);
+
+    const PureIOC::PoolStats stats = pool.stats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.recycled);
+    EXPECT_DOUBLE_EQ(0.5, stats.hitRate());
+}
+
+TEST_F(ServicePoolTest, DiscardsInstancesBeyondCapacity) {
+    PureIOC::PoolOptions options;
+    options.capacity = 0;
+    options.threadCache = 1;
+    PureIOC::ServicePool<Buffer> pool(options);
+
+    {
+        auto first = pool.acquire();
+        auto second = pool.acquire();
+        EXPECT_EQ(2, Buffer::live);
+    }
+
+    EXPECT_EQ(1, Buffer::live);
+    EXPECT_EQ(1u, pool.stats().recycled);
+    EXPECT_EQ(1u, pool.stats().discarded);
+}
+
+TEST_F(ServicePoolTest, FailedResetDiscardsInstance) {
+    PureIOC::ServicePool<Buffer> pool([] { return std::make_unique<Buffer>(); }, [](Buffer &) {
+        throw std::runtime_error("reset failed");
+    });
+
+    pool.acquire().reset();
+
+    EXPECT_EQ(0, Buffer::live);
+    EXPECT_EQ(1u, pool.stats().discarded);
+    EXPECT_EQ(0u, pool.stats().recycled);
+}
+
+TEST_F(ServicePoolTest, InstanceOutlivesPool) {
+    std::shared_ptr<Buffer> buffer;
+    {
+        PureIOC::ServicePool<Buffer> pool;
+        buffer = pool.acquire();
+    }
+
+    EXPECT_EQ(1, Buffer::live);
+    buffer.reset();
+    EXPECT_EQ(0, Buffer::live);
+}
+
+TEST_F(ServicePoolTest, InstancesCachedByExitingThreadReturnToPool) {
+    PureIOC::ServicePool<Buffer> pool;
+    Buffer *released = nullptr;
+    std::thread([&] {
+        auto buffer = pool.acquire();
+        released = buffer.get();
+    }).join();
+
+    EXPECT_EQ(released, pool.acquire().get());
+    EXPECT_EQ(1u, pool.stats().hits);
+}
+
+TEST_F(ServicePoolTest, NullInstanceFromFactoryIsNotPooled) {
+    PureIOC::ServicePool<Buffer> pool([] { return std::unique_ptr<Buffer>(); }, nullptr);
+
+    EXPECT_EQ(nullptr, pool.acquire());
+    EXPECT_EQ(0u, pool.stats().recycled);
+    EXPECT_EQ(0u, pool.stats().discarded);
+}
+
+TEST_F(ServicePoolTest, CachesOfPoolsDestroyedOnOtherThreadsAreReleased) {
+    auto destroyed = std::make_unique<PureIOC::ServicePool<Buffer>>();
+    std::promise<void> cached;
+    std::promise<void> released;
+    int live = -1;
+    std::thread worker([&] {
+        destroyed->acquire().reset();
+        cached.set_value();
+        released.get_future().wait();
+
+        PureIOC::ServicePool<Buffer> pool;
+        auto buffer = pool.acquire();
+        live = Buffer::live;
+    });
+
+    cached.get_future().wait();
+    destroyed.reset();
+    EXPECT_EQ(1, Buffer::live);
+    released.set_value();
+    worker.join();
+
+    EXPECT_EQ(1, live);
+}
+
+TEST_F(ServicePoolTest, RegisteredPoolServesResolutions) {
+    auto pool = std::make_shared<PureIOC::ServicePool<Buffer>>();
+    ASSERT_TRUE(PureIOC::registerPooled<Buffer>(pool));
+    EXPECT_EQ(PureIOC::ServiceLifetime::Pooled, PureIOC::currentContainer()->getLifetime(typeid(Buffer)));
+    EXPECT_FALSE(PureIOC::isCacheable(typeid(Buffer)));
+
+    Buffer *first = PureIOC::getService<Buffer>().get();
+    auto held = PureIOC::getService<Buffer>();
+    EXPECT_EQ(first, held.get());
+    EXPECT_NE(held, PureIOC::getService<Buffer>());
+
+    EXPECT_EQ(2u, pool->stats().misses);
+    EXPECT_EQ(1u, pool->stats().hits);
+}
+
+TEST_F(ServicePoolTest, RegisteredPoolWithContract) {
+    auto pool = std::make_shared<PureIOC::ServicePool<Buffer>>();
+    ASSERT_TRUE(PureIOC::registerPooled<Buffer>("scratch", pool));
+
+    EXPECT_NE(nullptr, PureIOC::getService<Buffer>("scratch"));
+    EXPECT_EQ(nullptr, PureIOC::getService<Buffer>());
+}
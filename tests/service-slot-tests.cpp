@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+#include <typeindex>
+
+#include <service-slot.h>
+
+namespace {
+struct FirstSlotType {};
+struct SecondSlotType {};
+}
+
+TEST(ServiceSlot, SameTypeGetsSameSlot) {
+    EXPECT_EQ(PureIOC::typeSlot<FirstSlotType>(), PureIOC::typeSlot<FirstSlotType>());
+    EXPECT_EQ(PureIOC::typeSlot<FirstSlotType>(), PureIOC::typeSlot(std::type_index(typeid(FirstSlotType))));
+}
+
+TEST(ServiceSlot, DistinctTypesGetDistinctSlots) {
+    EXPECT_NE(PureIOC::typeSlot<FirstSlotType>(), PureIOC::typeSlot<SecondSlotType>());
+}
+
+TEST(ServiceSlot, TypeIndexLookupAssignsSlotForTemplate) {
+    struct LateType {};
+    const std::size_t slot = PureIOC::typeSlot(std::type_index(typeid(LateType)));
+    EXPECT_EQ(slot, PureIOC::typeSlot<LateType>());
+}
+
+TEST(ServiceSlot, SlotTypeMapsBackToTheType) {
+    EXPECT_EQ(std::type_index(typeid(SecondSlotType)), PureIOC::slotType(PureIOC::typeSlot<SecondSlotType>()));
+    EXPECT_EQ(std::type_index(typeid(void)), PureIOC::slotType(static_cast<std::size_t>(-1)));
+}
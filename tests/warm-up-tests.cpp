@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <typeindex>
+#include <vector>
+
+#include <container-manager.h>
+#include <locator.h>
+#include <locator-mutable.h>
+#include <warm-up.h>
+
+namespace {
+template <int N>
+struct Warm {
+    int order = 0;
+};
+
+std::atomic<int> g_sequence{0};
+
+template <int N>
+std::shared_ptr<Warm<N>> makeWarm(std::atomic<int> &constructions) {
+    ++constructions;
+    auto warm = std::make_shared<Warm<N>>();
+    warm->order = ++g_sequence;
+    return warm;
+}
+
+const PureIOC::WarmUpResult *find(const std::vector<PureIOC::WarmUpResult> &results, const std::type_index &type) {
+    for (const PureIOC::WarmUpResult &result : results) {
+        if (result.type == type) {
+            return &result;
+        }
+    }
+
+    return nullptr;
+}
+
+class WarmUpTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        PureIOC::registerContainer(PureIOC::ContainerOptions());
+        g_sequence = 0;
+    }
+
+    void TearDown() override {
+        PureIOC::registerContainer(nullptr);
+    }
+};
+}
+
+TEST_F(WarmUpTest, ConstructsEveryLazySingleton) {
+    std::atomic<int> singletons{0};
+    std::atomic<int> transients{0};
+    PureIOC::registerLazySingleton<Warm<1>>([&] { return makeWarm<1>(singletons); });
+    PureIOC::registerLazySingleton<Warm<2>>([&] { return makeWarm<2>(singletons); });
+    PureIOC::registerLazySingleton<Warm<3>>("named", [&] { return makeWarm<3>(singletons); });
+    PureIOC::registerService<Warm<4>>([&] { return makeWarm<4>(transients); });
+
+    std::vector<PureIOC::WarmUpResult> results = PureIOC::warmUp(2);
+
+    ASSERT_EQ(3u, results.size());
+    for (const PureIOC::WarmUpResult &result : results) {
+        EXPECT_TRUE(result.constructed);
+        EXPECT_FALSE(result.error);
+        EXPECT_GE(result.duration.count(), 0);
+    }
+    EXPECT_EQ(3, singletons.load());
+    EXPECT_EQ(0, transients.load());
+
+    const PureIOC::WarmUpResult *named = find(results, typeid(Warm<3>));
+    ASSERT_NE(nullptr, named);
+    EXPECT_EQ(PureIOC::internContract("named"), named->contract);
+
+    PureIOC::getService<Warm<1>>();
+    PureIOC::getService<Warm<3>>("named");
+    EXPECT_EQ(3, singletons.load());
+}
+
+TEST_F(WarmUpTest, DependenciesAreConstructedFirst) {
+    std::atomic<int> constructions{0};
+    PureIOC::registerLazySingleton<Warm<1>>([&] { return makeWarm<1>(constructions); });
+    PureIOC::registerLazySingleton<Warm<2>>([&] { return makeWarm<2>(constructions); });
+    PureIOC::registerLazySingleton<Warm<3>>([&] { return makeWarm<3>(constructions); });
+
+    std::vector<PureIOC::WarmUpResult> results = PureIOC::WarmUpPlan()
+                                                     .dependsOn<Warm<1>, Warm<2>>()
+                                                     .dependsOn<Warm<2>, Warm<3>>()
+                                                     .threads(4)
+                                                     .run();
+
+    ASSERT_EQ(3u, results.size());
+    EXPECT_EQ(std::type_index(typeid(Warm<3>)), results[0].type);
+    EXPECT_EQ(std::type_index(typeid(Warm<2>)), results[1].type);
+    EXPECT_EQ(std::type_index(typeid(Warm<1>)), results[2].type);
+    EXPECT_LT(PureIOC::getService<Warm<3>>()->order, PureIOC::getService<Warm<2>>()->order);
+    EXPECT_LT(PureIOC::getService<Warm<2>>()->order, PureIOC::getService<Warm<1>>()->order);
+}
+
+TEST_F(WarmUpTest, IncludeSelectsSingletons) {
+    std::atomic<int> constructions{0};
+    PureIOC::registerLazySingleton<Warm<1>>([&] { return makeWarm<1>(constructions); });
+    PureIOC::registerLazySingleton<Warm<2>>([&] { return makeWarm<2>(constructions); });
+
+    std::vector<PureIOC::WarmUpResult> results = PureIOC::WarmUpPlan().include<Warm<2>>().dependsOn<Warm<2>, Warm<1>>().run();
+
+    ASSERT_EQ(1u, results.size());
+    EXPECT_EQ(std::type_index(typeid(Warm<2>)), results[0].type);
+    EXPECT_EQ(1, constructions.load());
+}
+
+TEST_F(WarmUpTest, ReportsReadyAndFailingSingletons) {
+    std::atomic<int> constructions{0};
+    bool fail = true;
+    PureIOC::registerLazySingleton<Warm<1>>([&] { return makeWarm<1>(constructions); });
+    PureIOC::registerLazySingleton<Warm<2>>([&]() -> std::shared_ptr<Warm<2>> {
+        if (fail) {
+            throw std::runtime_error("not yet");
+        }
+        return makeWarm<2>(constructions);
+    });
+    PureIOC::getService<Warm<1>>();
+
+    std::vector<PureIOC::WarmUpResult> results = PureIOC::warmUp(1);
+
+    const PureIOC::WarmUpResult *ready = find(results, typeid(Warm<1>));
+    ASSERT_NE(nullptr, ready);
+    EXPECT_FALSE(ready->constructed);
+    EXPECT_FALSE(ready->error);
+
+    const PureIOC::WarmUpResult *failed = find(results, typeid(Warm<2>));
+    ASSERT_NE(nullptr, failed);
+    EXPECT_FALSE(failed->constructed);
+    EXPECT_THROW(std::rethrow_exception(failed->error), std::runtime_error);
+
+    fail = false;
+    std::vector<PureIOC::WarmUpResult> retried = PureIOC::WarmUpPlan().include<Warm<2>>().run();
+    ASSERT_EQ(1u, retried.size());
+    EXPECT_TRUE(retried[0].constructed);
+    EXPECT_NE(nullptr, PureIOC::getService<Warm<2>>());
+    EXPECT_EQ(2, constructions.load());
+}
+
+TEST_F(WarmUpTest, CycleDoesNotStallTheWarmUp) {
+    std::atomic<int> constructions{0};
+    PureIOC::registerLazySingleton<Warm<1>>([&] { return makeWarm<1>(constructions); });
+    PureIOC::registerLazySingleton<Warm<2>>([&] { return makeWarm<2>(constructions); });
+    PureIOC::registerLazySingleton<Warm<3>>([&] { return makeWarm<3>(constructions); });
+
+    std::vector<PureIOC::WarmUpResult> results = PureIOC::WarmUpPlan()
+                                                     .dependsOn<Warm<1>, Warm<2>>()
+                                                     .dependsOn<Warm<2>, Warm<1>>()
+                                                     .dependsOn<Warm<1>, Warm<3>>()
+                                                     .threads(2)
+                                                     .run();
+
+    ASSERT_EQ(3u, results.size());
+    EXPECT_EQ(3, constructions.load());
+    EXPECT_LT(PureIOC::getService<Warm<3>>()->order, PureIOC::getService<Warm<1>>()->order);
+}
+
+TEST_F(WarmUpTest, RacingResolutionsConstructOnce) {
+    std::atomic<int> constructions{0};
+    PureIOC::registerLazySingleton<Warm<1>>([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return makeWarm<1>(constructions);
+    });
+
+    std::thread resolver([] { PureIOC::getService<Warm<1>>(); });
+    std::vector<PureIOC::WarmUpResult> results = PureIOC::warmUp(4);
+    resolver.join();
+
+    ASSERT_EQ(1u, results.size());
+    EXPECT_FALSE(results[0].error);
+    EXPECT_EQ(1, constructions.load());
+}